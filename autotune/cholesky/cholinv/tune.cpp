@@ -4,6 +4,7 @@
 #include <iomanip>
 
 #include "../../../src/alg/cholesky/cholinv/cholinv.h"
+#include "../../../src/alg/generate/spectrum/spectrum.h"
 #include "../../../test/cholesky/validate.h"
 #include "../../util.h"
 
@@ -14,8 +15,21 @@ size_t num_iter,compare,configuration_id;
 double total_reference_time;
 double total_time;
 double overhead_bin;
+double _kappa_; size_t _spectrum_;
 std::ofstream cp_stream_times, cp_stream_costs, cross_stream_times, cross_stream_costs;
 
+// Resets the input matrix before each run. A matrix with prescribed condition number is generated once and copied thereafter.
+template<typename MatrixType, typename CommType>
+void reset_matrix(MatrixType& M, CommType& topo){
+  if (_kappa_ == 0){ M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, 0,true); return; }
+  static std::vector<typename MatrixType::ScalarType> source;
+  if (source.size() == 0){
+    generate::spectrum::invoke(M, topo.x, topo.y, topo.d, topo.d, topo, _kappa_, static_cast<generate::distribution>(_spectrum_), 0, true);
+    source.assign(M.data(), M.data()+M.num_elems());
+  }
+  else{ std::memcpy(M.data(), &source[0], M.num_elems()*sizeof(typename MatrixType::ScalarType)); }
+}
+
 template<typename alg_type>
 class launch{
 public:
@@ -30,7 +44,7 @@ public:
     std::vector<float> decomp_pp_info(critter::get_max_per_process_costs());
     std::vector<float> decomp_vol_info(critter::get_volumetric_costs());
     critter::set_mechanism(1);
-    M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);
+    reset_matrix(M,topo);
     critter::set_mode(0);
     alg_type::factor(M,pack,topo);// Avoid allocation times
     auto reference_time = MPI_Wtime();
@@ -42,7 +56,7 @@ public:
     overhead_bin += (MPI_Wtime() - overhead_timer);
     if (_sample_constraint_mode_==3){
       overhead_timer = MPI_Wtime();
-      M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);
+      reset_matrix(M,topo);
       overhead_bin += (MPI_Wtime() - overhead_timer);
       critter::set_mechanism(2);
       critter::start();
@@ -55,7 +69,7 @@ public:
       if (i < _num_reference_iter_){
         critter::set_mechanism(0);
         critter::set_debug(1);
-        M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);
+        reset_matrix(M,topo);
         critter::start();
         alg_type::factor(M,pack,topo);
         critter::stop();
@@ -67,7 +81,7 @@ public:
         critter::set_debug(0);
         critter::set_mechanism(1);
       }
-      M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);// reset for ensuing autotuning iteration
+      reset_matrix(M,topo);// reset for ensuing autotuning iteration
       overhead_bin += (MPI_Wtime() - overhead_timer);
       critter::start();
       alg_type::factor(M,pack,topo);
@@ -97,7 +111,7 @@ public:
     std::vector<float> decomp_pp_info(critter::get_max_per_process_costs());
     std::vector<float> decomp_vol_info(critter::get_volumetric_costs());
     critter::set_mode(0);
-    M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);
+    reset_matrix(M,topo);
     auto reference_time = MPI_Wtime();
     alg_type::factor(M,pack,topo);// Avoid allocation times
     reference_time = MPI_Wtime() - reference_time;
@@ -108,7 +122,7 @@ public:
     overhead_bin += (MPI_Wtime() - overhead_timer);
     if (_sample_constraint_mode_==3){
       overhead_timer = MPI_Wtime();
-      M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);
+      reset_matrix(M,topo);
       overhead_bin += (MPI_Wtime() - overhead_timer);
       critter::set_mechanism(2);
       critter::start();
@@ -120,7 +134,7 @@ public:
       overhead_timer = MPI_Wtime();
       if (i < _num_reference_iter_){
         critter::set_debug(1);
-        M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);
+        reset_matrix(M,topo);
         critter::start();
         alg_type::factor(M,pack,topo);
         critter::stop();
@@ -130,7 +144,7 @@ public:
         critter::set_debug(0);
       }
       if (_rank_ == 0) std::cout << "past initial critter full-exec iter\n";
-      M.distribute_symmetric(topo.x, topo.y, topo.d, topo.d, _rank_/topo.c,true);// reset for ensuing autotuning iteration
+      reset_matrix(M,topo);// reset for ensuing autotuning iteration
       overhead_bin += (MPI_Wtime() - overhead_timer);
       critter::start();
       alg_type::factor(M,pack,topo);
@@ -154,7 +168,7 @@ public:
 int main(int argc, char** argv){
   using T = double; using U = int64_t; using MatrixType = matrix<T,U,rect>; using namespace cholesky;
 
-  MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &_provided_);
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &_provided_);
   MPI_Comm_rank(MPI_COMM_WORLD, &_rank_);
   MPI_Comm_size(MPI_COMM_WORLD, &_size_);
 
@@ -172,6 +186,10 @@ int main(int argc, char** argv){
   assert(compare==0 || compare==1);
   size_t space_dim = 5;
   if (argc > 10){ space_dim = atoi(argv[10]); }
+  _kappa_ = 0;// condition number of the generated matrix (0 - diagonally dominant random matrix)
+  if (argc > 11){ _kappa_ = atof(argv[11]); }
+  _spectrum_ = 0;// singular value distribution (0 - geometric, 1 - arithmetic, 2 - clustered)
+  if (argc > 12){ _spectrum_ = atoi(argv[12]); }
   using cholesky_type0 = typename cholesky::cholinv<policy::cholinv::NoSerialize,policy::cholinv::SaveIntermediates,policy::cholinv::NoReplication>;
   using cholesky_type1 = typename cholesky::cholinv<policy::cholinv::NoSerialize,policy::cholinv::SaveIntermediates,policy::cholinv::ReplicateCommComp>;
   using cholesky_type2 = typename cholesky::cholinv<policy::cholinv::NoSerialize,policy::cholinv::SaveIntermediates,policy::cholinv::ReplicateComp>;
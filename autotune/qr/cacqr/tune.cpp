@@ -4,6 +4,7 @@
 #include <iomanip>
 
 #include "../../../src/alg/qr/cacqr/cacqr.h"
+#include "../../../src/alg/generate/spectrum/spectrum.h"
 #include "../../../test/qr/validate.h"
 #include "../../util.h"
 
@@ -14,8 +15,22 @@ size_t num_iter,compare,configuration_id;
 double total_reference_time;
 double total_time;
 double overhead_bin;
+double _kappa_; size_t _spectrum_;
 std::ofstream cp_stream_times, cp_stream_costs, cross_stream_times, cross_stream_costs;
 
+// Resets the input matrix before each run. A matrix with prescribed condition number is generated once and copied thereafter.
+template<typename MatrixType, typename CommType>
+void reset_matrix(MatrixType& M, CommType& topo){
+  if (_kappa_ == 0){ M.distribute_random(topo.x, topo.y, topo.c, topo.d, 0); return; }
+  static std::vector<typename MatrixType::ScalarType> source;
+  if (source.size() == 0){
+    auto SquareTopo = topo::square(topo.cube,topo.c);
+    generate::spectrum::invoke(M, topo.x, topo.y, topo.c, topo.d, SquareTopo, _kappa_, static_cast<generate::distribution>(_spectrum_), 0);
+    source.assign(M.data(), M.data()+M.num_elems());
+  }
+  else{ std::memcpy(M.data(), &source[0], M.num_elems()*sizeof(typename MatrixType::ScalarType)); }
+}
+
 template<typename qr_type, typename cholesky_type>
 class launch{
 public:
@@ -26,7 +41,7 @@ public:
     auto overhead_timer = MPI_Wtime();
     typename cholesky_type::info<T,U> ci_pack(complete_inv,split,bcMultiplier,'U');
     typename qr_type::info<T,U,decltype(ci_pack)::alg_type> pack(variant,ci_pack);
-    M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+    reset_matrix(M,topo);
     critter::set_mode(0);
     qr_type::factor(M, pack, topo);
     auto reference_time = MPI_Wtime();
@@ -37,7 +52,7 @@ public:
     critter::set_mode();
     critter::set_mechanism(0);
     critter::set_debug(1);
-    M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+    reset_matrix(M,topo);
     critter::start();
     qr_type::factor(M, pack, topo);
     critter::stop();
@@ -48,7 +63,7 @@ public:
     write_cross_info(cross_stream_times,cross_stream_costs,compare,configuration_id,decomp_cp_info,decomp_pp_info,decomp_vol_info);
     critter::set_debug(0);
     critter::set_mechanism(1);
-    M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+    reset_matrix(M,topo);
     overhead_bin += (MPI_Wtime() - overhead_timer);
     if (_sample_constraint_mode_==3){
       critter::set_mechanism(2);
@@ -59,7 +74,7 @@ public:
     }
     for (size_t i=0; i<num_iter; i++){
       overhead_timer = MPI_Wtime();
-      M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+      reset_matrix(M,topo);
       overhead_bin += (MPI_Wtime() - overhead_timer);
       critter::start();
       qr_type::factor(M, pack, topo);
@@ -86,7 +101,7 @@ public:
     auto overhead_timer = MPI_Wtime();
     typename cholesky_type::info<T,U> ci_pack(complete_inv,split,bcMultiplier,'U');
     typename qr_type::info<T,U,decltype(ci_pack)::alg_type> pack(variant,ci_pack);
-    M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+    reset_matrix(M,topo);
     critter::set_mode(0);
     auto reference_time = MPI_Wtime();
     qr_type::factor(M, pack, topo);
@@ -95,7 +110,7 @@ public:
     total_reference_time += reference_time;
     critter::set_mode();
     critter::set_debug(1);
-    M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+    reset_matrix(M,topo);
     critter::start();
     qr_type::factor(M, pack, topo);
     critter::stop();
@@ -103,7 +118,7 @@ public:
     std::vector<float> decomp_pp_info(critter::get_max_per_process_costs()); critter::get_max_per_process_costs(&decomp_pp_info[0]);
     std::vector<float> decomp_vol_info(critter::get_volumetric_costs()); critter::get_volumetric_costs(&decomp_vol_info[0]);
     critter::set_debug(0);
-    M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+    reset_matrix(M,topo);
     overhead_bin += (MPI_Wtime() - overhead_timer);
     if (_sample_constraint_mode_==3){
       critter::set_mechanism(2);
@@ -114,7 +129,7 @@ public:
     }
     for (size_t i=0; i<num_iter; i++){
       overhead_timer = MPI_Wtime();
-      M.distribute_random(topo.x, topo.y, topo.c, topo.d, _rank_/topo.c);
+      reset_matrix(M,topo);
       overhead_bin += (MPI_Wtime() - overhead_timer);
       critter::start();
       qr_type::factor(M, pack, topo);
@@ -138,7 +153,7 @@ public:
 int main(int argc, char** argv){
   using T = double; using U = int64_t; using MatrixType = matrix<T,U,rect>; using namespace cholesky;
 
-  MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &_provided_);
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &_provided_);
   MPI_Comm_rank(MPI_COMM_WORLD, &_rank_);
   MPI_Comm_size(MPI_COMM_WORLD, &_size_);
 
@@ -158,6 +173,10 @@ int main(int argc, char** argv){
   if (argc > 12){
     space_dim = atoi(argv[12]);
   }
+  _kappa_ = 0;// condition number of the generated matrix (0 - uniform random matrix)
+  if (argc > 13){ _kappa_ = atof(argv[13]); }
+  _spectrum_ = 0;// singular value distribution (0 - geometric, 1 - arithmetic, 2 - clustered)
+  if (argc > 14){ _spectrum_ = atoi(argv[14]); }
   using cholesky_type0 = typename cholesky::cholinv<policy::cholinv::NoSerialize,policy::cholinv::SaveIntermediates,policy::cholinv::NoReplication>;
   using cholesky_type1 = typename cholesky::cholinv<policy::cholinv::NoSerialize,policy::cholinv::SaveIntermediates,policy::cholinv::ReplicateCommComp>;
   using cholesky_type2 = typename cholesky::cholinv<policy::cholinv::NoSerialize,policy::cholinv::SaveIntermediates,policy::cholinv::ReplicateComp>;
@@ -1,15 +1,15 @@
 /* Author: Edward Hutter */
 
 #include "../../src/alg/cholesky/cholinv/cholinv.h"
+#include "../../src/alg/generate/spectrum/spectrum.h"
 #include "../../test/cholesky/validate.h"
 
 using namespace std;
 
-int main(int argc, char** argv){
-  using T = double; using U = int64_t; using MatrixType = matrix<T,U,rect>; using namespace cholesky;
-
-  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+template<typename T>
+void run(int argc, char** argv, int rank, int size){
+  using U = int64_t; using MatrixType = matrix<T,U,rect>; using namespace cholesky;
+  using R = decltype(std::abs(T()));
 
   char dir          = 'U';
   U num_rows        = atoi(argv[1]);// number of rows in global matrix
@@ -20,6 +20,8 @@ int main(int argc, char** argv){
   size_t layout     = atoi(argv[6]);// arranges sub-communicator layout
   size_t num_chunks = atoi(argv[7]);// splits up communication in summa into nonblocking chunks
   size_t num_iter   = atoi(argv[8]);// number of simulations of the algorithm for performance testing
+  R kappa           = argc > 9 ? atof(argv[9]) : 0;// condition number of the generated matrix (0 - diagonally dominant random matrix)
+  size_t spectrum   = argc > 10 ? atoi(argv[10]) : 0;// singular value distribution (0 - geometric, 1 - arithmetic, 2 - clustered)
 
 #ifdef CRITTER
   std::vector<std::string> symbols = {
@@ -31,17 +33,21 @@ int main(int argc, char** argv){
   using cholesky_type = typename cholesky::cholinv<policy::cholinv::Serialize,policy::cholinv::SaveIntermediates,policy::cholinv::NoReplication>;
 //  using cholesky_type = typename cholesky::cholinv<policy::cholinv::Serialize,policy::cholinv::SaveIntermediates,policy::cholinv::ReplicationCommComp>;
 //  using cholesky_type = typename cholesky::cholinv<policy::cholinv::Serialize,policy::cholinv::SaveIntermediates,policy::cholinv::ReplicateComp>;
+//  using cholesky_type = typename cholesky::cholinv<policy::cholinv::Serialize,policy::cholinv::FlushIntermediates,policy::cholinv::NoReplication>;
+//  using cholesky_type = typename cholesky::cholinv<policy::cholinv::SerializeRFP,policy::cholinv::SaveIntermediates,policy::cholinv::NoReplication>;
   size_t process_cube_dim = std::nearbyint(std::ceil(pow(size,1./3.)));
   size_t rep_factor = process_cube_dim/rep_div;
-  T residual_error_local,residual_error_global; auto mpi_dtype = mpi_type<T>::type;
+  R residual_error_local,residual_error_global; auto mpi_dtype = mpi_type<R>::type;
   { 
     auto SquareTopo = topo::square(MPI_COMM_WORLD,rep_factor,layout,num_chunks);
     MatrixType A(num_rows,num_rows, SquareTopo.d, SquareTopo.d);
-    A.distribute_symmetric(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, rank/SquareTopo.c,true);
+    if (kappa == 0) A.distribute_symmetric(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, 0,true);
+    else generate::spectrum::invoke(A, SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, SquareTopo, kappa, static_cast<generate::distribution>(spectrum), 0, true);
     // Generate algorithmic structure via instantiating packs
     cholesky_type::info<T,U> pack(complete_inv,split,bcMultiplier,dir);
     // Warm cache and BLAS/LAPACK/MPI routines
     cholesky_type::factor(A, pack, SquareTopo);
+    StandardAllocator::reset_stats(); PoolAllocator::reset_stats(); serialize_stats::reset();
 
     for (size_t i=0; i<num_iter; i++){
       MPI_Barrier(MPI_COMM_WORLD);
@@ -60,12 +66,32 @@ int main(int argc, char** argv){
 #endif
 /* For calculating error. No longer relevant.
       cholesky_type::factor(A, pack, SquareTopo);
-      residual_error_local = cholesky::validate<cholesky_type>::residual(A, pack, SquareTopo);
+      residual_error_local = std::abs(cholesky::validate<cholesky_type>::residual(A, pack, SquareTopo));
       MPI_Reduce(&residual_error_local, &residual_error_global, 1, mpi_dtype, MPI_MAX, 0, MPI_COMM_WORLD);
       if (rank==0){ std::cout << residual_error_global << std::endl; }
 */
     }
+    // Buffer requests made by matrix instances vs. buffers actually obtained from the system, summed over all iterations
+    if (rank==0){
+      auto& s1 = StandardAllocator::stats(); auto& s2 = PoolAllocator::stats();
+      std::cout << "standard allocator - requests " << s1.num_requests << " (" << s1.bytes_requested << " bytes), system allocations " << s1.num_allocs << " (" << s1.bytes_allocated << " bytes)" << std::endl;
+      std::cout << "pool allocator - requests " << s2.num_requests << " (" << s2.bytes_requested << " bytes), system allocations " << s2.num_allocs << " (" << s2.bytes_allocated << " bytes)" << std::endl;
+      std::cout << "serialize - " << serialize_stats::bytes()/std::max(num_iter,size_t(1)) << " bytes copied per factorization" << std::endl;
+    }
+  }
+}
+
+int main(int argc, char** argv){
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (rank==0) std::cout << "backend - " << blas::engine::backend::name() << " - threads - " << blas::engine::backend::get_num_threads() << std::endl;
+
+  size_t precision = argc > 11 ? atoi(argv[11]) : 1;// scalar type (0 - float, 1 - double, 2 - complex<float>, 3 - complex<double>)
+  switch (precision){
+    case 0: run<float>(argc,argv,rank,size); break;
+    case 1: run<double>(argc,argv,rank,size); break;
+    case 2: run<std::complex<float>>(argc,argv,rank,size); break;
+    case 3: run<std::complex<double>>(argc,argv,rank,size); break;
   }
   MPI_Finalize();
-  return 0;
 }
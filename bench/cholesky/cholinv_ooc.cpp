@@ -0,0 +1,58 @@
+/* Author: Edward Hutter */
+
+#include "../../src/alg/cholesky/cholinv/cholinv.h"
+#include "../../src/alg/generate/spectrum/spectrum.h"
+
+using namespace std;
+
+// Out-of-core variant of the cholinv benchmark: the input matrix and every trailing-block intermediate are backed by
+//   per-rank mappings of files in $CAPITAL_MMAP_DIR, so the local problem may exceed physical memory
+int main(int argc, char** argv){
+  using T = double; using U = int64_t; using MatrixType = matrix<T,U,rect,OffloadEachGemm,MappedAllocator>; using namespace cholesky;
+
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (rank==0) std::cout << "backend - " << blas::engine::backend::name() << " - threads - " << blas::engine::backend::get_num_threads() << std::endl;
+
+  char dir          = 'U';
+  U num_rows        = atoi(argv[1]);// number of rows in global matrix
+  U rep_div         = atoi(argv[2]);// cuts the depth of cubic process grid (only trivial support of value '1' is supported)
+  bool complete_inv = atoi(argv[3]);// decides whether to complete inverse in cholinv
+  U split           = atoi(argv[4]);// split factor in cholinv
+  U bcMultiplier    = atoi(argv[5]);// base case depth factor in cholinv
+  size_t layout     = atoi(argv[6]);// arranges sub-communicator layout
+  size_t num_chunks = atoi(argv[7]);// splits up communication in summa into nonblocking chunks
+  size_t num_iter   = atoi(argv[8]);// number of simulations of the algorithm for performance testing
+  T kappa           = argc > 9 ? atof(argv[9]) : 0;// condition number of the generated matrix (0 - diagonally dominant random matrix)
+  size_t spectrum   = argc > 10 ? atoi(argv[10]) : 0;// singular value distribution (0 - geometric, 1 - arithmetic, 2 - clustered)
+
+  using cholesky_type = typename cholesky::cholinv<policy::cholinv::Serialize,policy::cholinv::StreamIntermediates,policy::cholinv::NoReplication>;
+  size_t process_cube_dim = std::nearbyint(std::ceil(pow(size,1./3.)));
+  size_t rep_factor = process_cube_dim/rep_div;
+  {
+    auto SquareTopo = topo::square(MPI_COMM_WORLD,rep_factor,layout,num_chunks);
+    MatrixType A(num_rows,num_rows, SquareTopo.d, SquareTopo.d);
+    if (kappa == 0) A.distribute_symmetric(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, 0,true);
+    else generate::spectrum::invoke(A, SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, SquareTopo, kappa, static_cast<generate::distribution>(spectrum), 0, true);
+    cholesky_type::info<T,U> pack(complete_inv,split,bcMultiplier,dir);
+    // Warm BLAS/LAPACK/MPI routines
+    cholesky_type::factor(A, pack, SquareTopo);
+    StandardAllocator::reset_stats(); MappedAllocator::reset_stats();
+
+    for (size_t i=0; i<num_iter; i++){
+      MPI_Barrier(MPI_COMM_WORLD);
+      auto start_time = MPI_Wtime();
+      cholesky_type::factor(A, pack, SquareTopo);
+      auto total_time = MPI_Wtime()-start_time;
+      if (rank==0) std::cout << "total time - " << total_time << std::endl;
+    }
+    // Bytes that went through file-backed mappings vs. bytes that stayed in anonymous memory, summed over all iterations
+    if (rank==0){
+      auto& s1 = StandardAllocator::stats(); auto& s2 = MappedAllocator::stats();
+      std::cout << "standard allocator - requests " << s1.num_requests << " (" << s1.bytes_requested << " bytes), system allocations " << s1.num_allocs << " (" << s1.bytes_allocated << " bytes)" << std::endl;
+      std::cout << "mapped allocator - requests " << s2.num_requests << " (" << s2.bytes_requested << " bytes), system allocations " << s2.num_allocs << " (" << s2.bytes_allocated << " bytes)" << std::endl;
+    }
+  }
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,74 @@
+/* Author: Edward Hutter */
+
+#include "../../src/alg/alg.h"
+
+using namespace std;
+
+// Library and fixed-size kernel timings for the small triangular calls made at the cholinv base case and recursion leaves.
+//   Each call works on a fresh copy of the same symmetric positive definite input; the copy is not timed.
+template<typename T>
+void run(int n, int num_columns, size_t num_iter){
+  std::vector<T> spd(n*n), tri(n*n), rhs(n*num_columns), work(n*n), lib(n*num_columns), mk(n*num_columns);
+  for (int j=0; j<n; j++){
+    for (int i=0; i<n; i++){ spd[j*n+i] = T(1)/(1+std::abs(i-j)) + (i==j ? n : 0); }
+  }
+  for (int i=0; i<n*num_columns; i++){ rhs[i] = T(i%7)-3; }
+
+  auto time_call = [&](auto&& call, std::vector<T>& dest, const std::vector<T>& src){
+    double t = 0;
+    for (size_t i=0; i<num_iter; i++){
+      dest = src;
+      auto start_time = MPI_Wtime();
+      call();
+      t += MPI_Wtime() - start_time;
+    }
+    return t/num_iter;
+  };
+  auto max_diff = [](const std::vector<T>& x, const std::vector<T>& y, int rows, int cols, bool upper){
+    T diff = 0;
+    for (int j=0; j<cols; j++){ for (int i=0; i<(upper ? j+1 : rows); i++){ diff = std::max(diff,std::abs(x[j*rows+i]-y[j*rows+i])); } }
+    return diff;
+  };
+
+  std::vector<T> ref(n*n);
+  int save_threshold = microkernel::order_threshold();
+  microkernel::order_threshold() = 0;
+  lapack::ArgPack_potrf potrfArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper);
+  lapack::ArgPack_trtri trtriArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper, lapack::Diag::AlapackNonUnit);
+  blas::ArgPack_trmm<T> trmmArgs(blas::Order::AblasColumnMajor, blas::Side::AblasLeft, blas::UpLo::AblasUpper, blas::Transpose::AblasTrans, blas::Diag::AblasNonUnit, 1.);
+  // The Cholesky factor of the input is the well-conditioned triangular operand for trtri and trmm
+  tri = spd; lapack::engine::_potrf(&tri[0],n,n,potrfArgs);
+
+  double potrf_lib = time_call([&](){ lapack::engine::_potrf(&work[0],n,n,potrfArgs); },work,spd); ref = work;
+  double potrf_mk = time_call([&](){ microkernel::potrf(&work[0],n,n); },work,spd);
+  T potrf_diff = max_diff(ref,work,n,n,true);
+  double trtri_lib = time_call([&](){ lapack::engine::_trtri(&work[0],n,n,trtriArgs); },work,tri); ref = work;
+  double trtri_mk = time_call([&](){ microkernel::trtri(&work[0],n,n); },work,tri);
+  T trtri_diff = max_diff(ref,work,n,n,true);
+  double trmm_lib = time_call([&](){ blas::engine::_trmm(&tri[0],&lib[0],n,num_columns,n,n,trmmArgs); },lib,rhs);
+  double trmm_mk = time_call([&](){ microkernel::trmm(&tri[0],&mk[0],n,num_columns,n,n,true,true,T(1)); },mk,rhs);
+  T trmm_diff = max_diff(lib,mk,n,num_columns,false);
+  microkernel::order_threshold() = save_threshold;
+
+  std::cout << "order - " << n << " - potrf library/kernel - " << potrf_lib << " " << potrf_mk << " - trtri library/kernel - " << trtri_lib << " " << trtri_mk
+            << " - trmm library/kernel - " << trmm_lib << " " << trmm_mk << " - max difference - " << std::max(potrf_diff,std::max(trtri_diff,trmm_diff)) << std::endl;
+}
+
+int main(int argc, char** argv){
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  size_t num_iter = atoi(argv[1]);// number of timed repetitions of each call
+  int precision   = argc > 2 ? atoi(argv[2]) : 1;// 0 for float, 1 for double
+
+  // Each process measures independently; only rank 0 reports
+  if (rank==0){
+    std::cout << "backend - " << blas::engine::backend::name() << " - threads - " << blas::engine::backend::get_num_threads() << std::endl;
+    for (int n=8; n<=64; n+=8){
+      if (precision==0) run<float>(n,n,num_iter);
+      else run<double>(n,n,num_iter);
+    }
+  }
+  MPI_Finalize();
+  return 0;
+}
@@ -9,7 +9,7 @@ int main(int argc, char** argv){
   using MatrixTypeA = matrix<double,size_t,square,cyclic>;
 
   int rank,size,provided;
-  MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
@@ -8,8 +8,9 @@ using namespace std;
 int main(int argc, char** argv){
   using T = double; using U = int64_t; using MatrixType = matrix<T,U,lowertri>; using namespace inverse;
 
-  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (rank==0) std::cout << "backend - " << blas::engine::backend::name() << " - threads - " << blas::engine::backend::get_num_threads() << std::endl;
 
   char dir          = 'L';
   U num_rows        = atoi(argv[1]);// number of rows in global matrix
@@ -25,7 +26,7 @@ int main(int argc, char** argv){
   { 
     auto SquareTopo = topo::square(MPI_COMM_WORLD,rep_factor,layout,num_chunks);
     MatrixType A(num_rows,num_rows, SquareTopo.d, SquareTopo.d);
-    A.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, rank/SquareTopo.c);
+    A.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, 0);
 
     // Generate algorithmic structure via instantiating packs
     trtri_type::info<T,U> pack(dir);
@@ -1,6 +1,7 @@
 /* Author: Edward Hutter */
 
 #include "../../src/alg/matmult/summa/summa.h"
+#include "../../src/alg/generate/spectrum/spectrum.h"
 
 using namespace std;
 
@@ -11,10 +12,11 @@ int main(int argc, char** argv){
   using MatrixTypeUT = matrix<T,U,uppertri>;
 
   int rank,size,provided;
-  MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   // size -- total number of processors in the 3D grid
   MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (rank==0) std::cout << "backend - " << blas::engine::backend::name() << " - threads - " << blas::engine::backend::get_num_threads() << std::endl;
 
   U globalMatrixSizeM  = atoi(argv[1]);
   U globalMatrixSizeN  = atoi(argv[2]);
@@ -23,6 +25,8 @@ int main(int argc, char** argv){
   size_t layout        = atoi(argv[5]);// arranges sub-communicator layout
   size_t num_chunks    = atoi(argv[6]);
   size_t numIterations = atoi(argv[7]);
+  T kappa              = argc > 8 ? atof(argv[8]) : 0;// condition number of A (0 - uniform random matrix), requires M >= K
+  size_t spectrum      = argc > 9 ? atoi(argv[9]) : 0;// singular value distribution (0 - geometric, 1 - arithmetic, 2 - clustered)
 
   auto mpi_dtype = mpi_type<T>::type;
   U pGridCubeDim = std::nearbyint(std::ceil(pow(size,1./3.)));
@@ -33,9 +37,10 @@ int main(int argc, char** argv){
     MatrixTypeR matB(globalMatrixSizeN,globalMatrixSizeK,SquareTopo.d,SquareTopo.d);
     MatrixTypeR matC(globalMatrixSizeN,globalMatrixSizeM,SquareTopo.d,SquareTopo.d);
     blas::ArgPack_gemm<T> blasArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasNoTrans, 1., 0.);
-    matA.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, rank/SquareTopo.c);
-    matB.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, rank/SquareTopo.c*(-1));
-    matC.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, rank/SquareTopo.c*(-1));
+    if (kappa == 0) matA.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, 0);
+    else generate::spectrum::invoke(matA, SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, SquareTopo, kappa, static_cast<generate::distribution>(spectrum), 0);
+    matB.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, 1);
+    matC.distribute_random(SquareTopo.x, SquareTopo.y, SquareTopo.d, SquareTopo.d, 2);
 
     // Loop for getting a good range of results.
     for (size_t i=0; i<numIterations; i++){
@@ -0,0 +1,47 @@
+/* Author: Edward Hutter */
+
+#include "../../src/alg/alg.h"
+
+using namespace std;
+
+template<typename AllocatorType>
+void run(const char* name, int64_t num_rows, int64_t num_columns, size_t num_iter){
+  using T = double; using U = int64_t; using MatrixType = matrix<T,U,rect,OffloadEachGemm,AllocatorType>;
+  auto alloc_time = MPI_Wtime();
+  MatrixType A(num_columns,num_rows,1,1); MatrixType B(num_columns,num_columns,1,1); MatrixType C(num_columns,num_rows,1,1);
+  A.distribute_random(0,0,1,1,0); B.distribute_random(0,0,1,1,1); C.distribute_random(0,0,1,1,2);
+  alloc_time = MPI_Wtime() - alloc_time;
+  blas::ArgPack_gemm<T> gemmArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasNoTrans, 1., 0.);
+  // Warm BLAS
+  blas::engine::_gemm(A.data(), B.data(), C.data(), num_rows, num_columns, num_columns, num_rows, num_columns, num_rows, gemmArgs);
+
+  double gemm_time=0, serialize_time=0;
+  for (size_t i=0; i<num_iter; i++){
+    auto start_time = MPI_Wtime();
+    blas::engine::_gemm(A.data(), B.data(), C.data(), num_rows, num_columns, num_columns, num_rows, num_columns, num_rows, gemmArgs);
+    gemm_time += MPI_Wtime() - start_time;
+    // copy the trailing half-block, as the recursive algorithms do
+    start_time = MPI_Wtime();
+    serialize<rect,rect>::invoke(A, C, num_columns/2, num_columns, num_rows/2, num_rows, num_columns/2, num_columns, num_rows/2, num_rows);
+    serialize_time += MPI_Wtime() - start_time;
+  }
+  std::cout << name << " - assemble+distribute time - " << alloc_time << " - gemm time - " << gemm_time/num_iter << " - serialize time - " << serialize_time/num_iter << std::endl;
+}
+
+int main(int argc, char** argv){
+  using U = int64_t;
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  U num_rows        = atoi(argv[1]);// number of rows in local matrix
+  U num_columns     = atoi(argv[2]);// number of columns in local matrix
+  size_t num_iter   = atoi(argv[3]);// number of timed repetitions of each kernel
+
+  // Each process measures independently; only rank 0 reports
+  if (rank==0){
+    run<StandardAllocator>("standard allocator",num_rows,num_columns,num_iter);
+    run<HugePageAllocator>("huge page allocator",num_rows,num_columns,num_iter);
+  }
+  MPI_Finalize();
+  return 0;
+}
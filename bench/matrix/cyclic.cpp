@@ -0,0 +1,104 @@
+/* Author: Edward Hutter */
+
+#include "../../src/alg/alg.h"
+
+using namespace std;
+
+// Scalar four-deep loops that util used before the transforms were fused and threaded; zeroing is a separate pass
+template<typename T>
+void reference_block_to_cyclic(T* blocked, T* cyclic, int64_t num_elems, int64_t num_rows_local, int64_t num_columns_local, int64_t sliceDim, bool packed){
+  int64_t num_rows_global = num_rows_local*sliceDim; int64_t num_columns_global = num_columns_local*sliceDim;
+  int64_t offset = num_elems/(sliceDim*sliceDim); int64_t off1 = 0;
+  for (int64_t i=0; i<num_columns_local; i++){
+    off1 += i;
+    for (int64_t j=0; j<sliceDim; j++){
+      int64_t write_idx = ((i*sliceDim)+j)*num_rows_global;
+      int64_t base = j*offset + (packed ? off1 : i*num_rows_local);
+      for (int64_t k=0; k<(packed ? i+1 : num_rows_local); k++){
+        for (int64_t z=0; z<((packed && k==i) ? j+1 : sliceDim); z++){
+          cyclic[write_idx++] = blocked[base + z*sliceDim*offset + k];
+        }
+      }
+    }
+  }
+  for (int64_t i=0; i<num_columns_global; i++){
+    for (int64_t j=i+1; j<num_rows_global; j++){
+      cyclic[i*num_rows_global+j]=0.;
+    }
+  }
+}
+
+template<typename T>
+void reference_cyclic_to_block(T* dest, T* src, int64_t num_elems, int64_t num_rows_local, int64_t num_columns_local, int64_t sliceDim, bool packed){
+  int64_t num_rows_global = num_rows_local*sliceDim;
+  int64_t offset = num_elems/(sliceDim*sliceDim); int64_t off1 = 0;
+  for (int64_t i=0; i<num_columns_local; i++){
+    off1 += i;
+    for (int64_t j=0; j<sliceDim; j++){
+      int64_t read_idx = ((i*sliceDim)+j)*num_rows_global;
+      int64_t base = j*offset + (packed ? off1 : i*num_rows_local);
+      for (int64_t k=0; k<(packed ? i+1 : num_rows_local); k++){
+        for (int64_t z=0; z<((packed && k==i) ? j+1 : sliceDim); z++){
+          dest[base + z*sliceDim*offset + k] = src[read_idx++];
+          if (packed) src[read_idx-1]=0.;
+        }
+      }
+    }
+  }
+}
+
+void run(int64_t num_rows_local, int64_t sliceDim, size_t num_iter, bool packed){
+  using T = double;
+  int64_t num_global = num_rows_local*sliceDim*num_rows_local*sliceDim;
+  int64_t num_elems = (packed ? num_rows_local*(num_rows_local+1)/2 : num_rows_local*num_rows_local)*sliceDim*sliceDim;
+  std::vector<T> blocked(num_elems), cyclic(num_global), reference(num_global), back(num_elems), reference_back(num_elems);
+  for (int64_t i=0; i<num_elems; i++){ blocked[i] = drand48(); }
+
+  double reference_time=0, fused_time=0, reference_back_time=0, fused_back_time=0;
+  int64_t bad=0;
+  for (size_t it=0; it<num_iter; it++){
+    std::fill(cyclic.begin(),cyclic.end(),-1.); std::fill(reference.begin(),reference.end(),-1.);
+    auto start_time = MPI_Wtime();
+    reference_block_to_cyclic(&blocked[0],&reference[0],num_elems,num_rows_local,num_rows_local,sliceDim,packed);
+    reference_time += MPI_Wtime() - start_time;
+    start_time = MPI_Wtime();
+    if (packed) util::block_to_cyclic_triangle(&blocked[0],&cyclic[0],num_elems,num_rows_local,num_rows_local,sliceDim);
+    else util::block_to_cyclic_rect(&blocked[0],&cyclic[0],num_rows_local,num_rows_local,sliceDim);
+    fused_time += MPI_Wtime() - start_time;
+    for (int64_t i=0; i<num_global; i++){ bad += (cyclic[i]!=reference[i]); }
+
+    start_time = MPI_Wtime();
+    reference_cyclic_to_block(&reference_back[0],&reference[0],num_elems,num_rows_local,num_rows_local,sliceDim,packed);
+    reference_back_time += MPI_Wtime() - start_time;
+    start_time = MPI_Wtime();
+    if (packed) util::cyclic_to_block_triangle(&back[0],&cyclic[0],num_elems,num_rows_local,num_rows_local,sliceDim);
+    else util::cyclic_to_block_rect(&back[0],&cyclic[0],num_rows_local,num_rows_local,sliceDim);
+    fused_back_time += MPI_Wtime() - start_time;
+    for (int64_t i=0; i<num_elems; i++){ bad += (back[i]!=reference_back[i]); }
+    for (int64_t i=0; i<num_global; i++){ bad += (cyclic[i]!=reference[i]); }
+  }
+  std::cout << (packed ? "triangle" : "rect") << " - sliceDim - " << sliceDim << " - local dimension - " << num_rows_local
+            << " - block_to_cyclic reference time - " << reference_time/num_iter << " - fused time - " << fused_time/num_iter
+            << " - cyclic_to_block reference time - " << reference_back_time/num_iter << " - fused time - " << fused_back_time/num_iter
+            << " - mismatches - " << bad << std::endl;
+}
+
+int main(int argc, char** argv){
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  int64_t max_local = atoi(argv[1]);// largest local dimension of each block
+  size_t num_iter   = atoi(argv[2]);// number of timed repetitions of each transform
+
+  // Each process measures independently; only rank 0 reports
+  if (rank==0){
+    for (int64_t sliceDim=1; sliceDim<=8; sliceDim*=2){
+      for (int64_t num_rows_local=8; num_rows_local<=max_local; num_rows_local*=4){
+        run(num_rows_local,sliceDim,num_iter,false);
+        run(num_rows_local,sliceDim,num_iter,true);
+      }
+    }
+  }
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,99 @@
+/* Author: Edward Hutter */
+
+#include "../../src/alg/alg.h"
+
+using namespace std;
+
+// Per-column memcpy loop that serialize used before the kernel layer and copy plans; packed-to-rect copies zero the opposite triangle element by element
+template<typename SrcStructure, typename DestStructure, typename SrcType, typename DestType>
+void reference_invoke(const SrcType& src, DestType& dest){
+  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
+  U range = src.num_columns_local();
+  T* s = src.data(); T* d = dest.data();
+  for (U i=0; i<range; i++){
+    U first = std::is_same<SrcStructure,lowertri>::value || std::is_same<DestStructure,lowertri>::value ? i : 0;
+    U last = std::is_same<SrcStructure,uppertri>::value || std::is_same<DestStructure,uppertri>::value ? i+1 : range;
+    memcpy(&d[dest.offset_local(i,first)],&s[src.offset_local(i,first)],(last-first)*sizeof(T));
+    if (std::is_same<DestStructure,rect>::value){
+      for (U j=0; j<first; j++){ d[dest.offset_local(i,j)] = 0; }
+      for (U j=last; j<range; j++){ d[dest.offset_local(i,j)] = 0; }
+    }
+  }
+}
+
+template<typename SrcStructure, typename DestStructure>
+void run(const char* name, int64_t num_columns, size_t num_iter){
+  using T = double; using U = int64_t;
+  matrix<T,U,SrcStructure> A(num_columns,num_columns,1,1); matrix<T,U,DestStructure> B(num_columns,num_columns,1,1);
+  A.distribute_random(0,0,1,1,0); B.distribute_random(0,0,1,1,1);
+  // Warm both buffers
+  reference_invoke<SrcStructure,DestStructure>(A,B);
+
+  size_t save_stream = serialize_kernel::stream_threshold();
+  double reference_time=0, kernel_time=0, cached_time=0;
+  for (size_t i=0; i<num_iter; i++){
+    auto start_time = MPI_Wtime();
+    reference_invoke<SrcStructure,DestStructure>(A,B);
+    reference_time += MPI_Wtime() - start_time;
+    start_time = MPI_Wtime();
+    serialize<SrcStructure,DestStructure>::invoke(A,B,0,num_columns,0,num_columns,0,num_columns,0,num_columns);
+    kernel_time += MPI_Wtime() - start_time;
+    // same kernels with streaming stores disabled, to separate the threading gain from the store path
+    serialize_kernel::stream_threshold() = std::numeric_limits<size_t>::max();
+    start_time = MPI_Wtime();
+    serialize<SrcStructure,DestStructure>::invoke(A,B,0,num_columns,0,num_columns,0,num_columns,0,num_columns);
+    cached_time += MPI_Wtime() - start_time;
+    serialize_kernel::stream_threshold() = save_stream;
+  }
+  size_t bytes = B.num_elems()*sizeof(T);
+  std::cout << name << " - reference time - " << reference_time/num_iter << " - kernel time - " << kernel_time/num_iter << " - cached kernel time - " << cached_time/num_iter
+            << " - kernel GB/s - " << (bytes*num_iter)/kernel_time/1e9 << std::endl;
+}
+
+// Per-call cost at small local dimensions, where offset arithmetic rather than bandwidth dominates. The first call builds the plan.
+template<typename SrcStructure, typename DestStructure>
+void run_small(const char* name, int64_t num_columns, size_t num_iter){
+  using T = double; using U = int64_t;
+  matrix<T,U,SrcStructure> A(num_columns,num_columns,1,1); matrix<T,U,DestStructure> B(num_columns,num_columns,1,1);
+  A.distribute_random(0,0,1,1,0); B.distribute_random(0,0,1,1,1);
+  serialize_plan::clear();
+  auto build_time = MPI_Wtime();
+  serialize<SrcStructure,DestStructure>::invoke(A,B,0,num_columns,0,num_columns,0,num_columns,0,num_columns);
+  build_time = MPI_Wtime() - build_time;
+
+  auto reference_time = MPI_Wtime();
+  for (size_t i=0; i<num_iter; i++){ reference_invoke<SrcStructure,DestStructure>(A,B); }
+  reference_time = MPI_Wtime() - reference_time;
+  auto plan_time = MPI_Wtime();
+  for (size_t i=0; i<num_iter; i++){ serialize<SrcStructure,DestStructure>::invoke(A,B,0,num_columns,0,num_columns,0,num_columns,0,num_columns); }
+  plan_time = MPI_Wtime() - plan_time;
+  std::cout << name << " - local dimension - " << num_columns << " - reference time per call - " << reference_time/num_iter << " - planned time per call - " << plan_time/num_iter
+            << " - plan build time - " << build_time << std::endl;
+}
+
+int main(int argc, char** argv){
+  using U = int64_t;
+  int rank,size,provided; MPI_Init_thread(&argc, &argv, MPI_THREAD_SINGLE, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank); MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  U num_columns     = atoi(argv[1]);// number of rows and columns in local matrix
+  size_t num_iter   = atoi(argv[2]);// number of timed repetitions of each kernel
+  if (argc > 3) serialize_kernel::thread_threshold() = atol(argv[3]);// bytes below which a copy stays on one thread
+  if (argc > 4) serialize_kernel::stream_threshold() = atol(argv[4]);// bytes above which a copy bypasses the cache
+
+  // Each process measures independently; only rank 0 reports
+  if (rank==0){
+    run<rect,rect>("rect -> rect",num_columns,num_iter);
+    run<uppertri,rect>("uppertri -> rect",num_columns,num_iter);
+    run<lowertri,rect>("lowertri -> rect",num_columns,num_iter);
+    run<rect,uppertri>("rect -> uppertri",num_columns,num_iter);
+    run<uppertri,uppertri>("uppertri -> uppertri",num_columns,num_iter);
+    for (U dim=8; dim<=64; dim*=2){
+      run_small<rect,rect>("rect -> rect",dim,1000*num_iter);
+      run_small<uppertri,rect>("uppertri -> rect",dim,1000*num_iter);
+      run_small<uppertri,uppertri>("uppertri -> uppertri",dim,1000*num_iter);
+    }
+  }
+  MPI_Finalize();
+  return 0;
+}
@@ -1,15 +1,15 @@
 /* Author: Edward Hutter */
 
 #include "../../src/alg/qr/cacqr/cacqr.h"
+#include "../../src/alg/generate/spectrum/spectrum.h"
 #include "../../test/qr/validate.h"
 
 using namespace std;
 
-int main(int argc, char** argv){
-  using T = double; using U = int64_t; using MatrixType = matrix<T,U,rect>;
-
-  int rank,size,provided; MPI_Init_thread(&argc,&argv,MPI_THREAD_SINGLE,&provided);
-  MPI_Comm_rank(MPI_COMM_WORLD,&rank); MPI_Comm_size(MPI_COMM_WORLD,&size);
+template<typename T>
+void run(int argc, char** argv, int rank, int size){
+  using U = int64_t; using MatrixType = matrix<T,U,rect>;
+  using R = decltype(std::abs(T()));
 
   size_t variant     = atoi(argv[1]);// 1 - cacqr, 2 - cacqr2
   U num_rows         = atoi(argv[2]);// number of rows in global matrix
@@ -23,36 +23,56 @@ int main(int argc, char** argv){
   size_t layout     = atoi(argv[10]);// arranges sub-communicator layout
   size_t num_chunks = atoi(argv[11]);// splits up communication in summa into nonblocking chunks
   size_t num_iter   = atoi(argv[12]);// number of simulations of the algorithm for performance testing
+  R kappa           = argc > 13 ? atof(argv[13]) : 0;// condition number of the generated matrix (0 - uniform random matrix)
+  size_t spectrum   = argc > 14 ? atoi(argv[14]) : 0;// singular value distribution (0 - geometric, 1 - arithmetic, 2 - clustered)
 
   using qr_type = qr::cacqr<qr::policy::cacqr::Serialize,qr::policy::cacqr::SaveIntermediates>;
   {
-    T residual_error,orthogonality_error; auto mpi_dtype = mpi_type<T>::type;
+    R residual_error,orthogonality_error; auto mpi_dtype = mpi_type<R>::type;
 
     for (int i=rep_factor_start; i<=rep_factor_end; i++){
       auto RectTopo = topo::rect(MPI_COMM_WORLD,i,layout,num_chunks);
       MatrixType A(num_columns,num_rows,RectTopo.c,RectTopo.d);
-      A.distribute_random(RectTopo.x, RectTopo.y, RectTopo.c, RectTopo.d, rank/RectTopo.c);
+      // A matrix with prescribed condition number is generated once per topology and copied before each run
+      std::vector<T> source;
+      if (kappa != 0){
+        auto SquareTopo = topo::square(RectTopo.cube,RectTopo.c);
+        generate::spectrum::invoke(A, RectTopo.x, RectTopo.y, RectTopo.c, RectTopo.d, SquareTopo, kappa, static_cast<generate::distribution>(spectrum), 0);
+        source.assign(A.data(), A.data()+A.num_elems());
+      }
+      auto reset = [&](){
+        if (kappa == 0) A.distribute_random(RectTopo.x, RectTopo.y, RectTopo.c, RectTopo.d, 0);
+        else std::memcpy(A.data(), &source[0], A.num_elems()*sizeof(T));
+      };
 
       for (int j=bcMultiplier_start; j<=bcMultiplier_end; j++){
         // Generate algorithmic structure via instantiating packs
         cholesky::cholinv<cholesky::policy::cholinv::Serialize,cholesky::policy::cholinv::SaveIntermediates,
                           cholesky::policy::cholinv::NoReplication>::info<T,U> ci_pack(complete_inv,split,j,'U');
-        qr_type::info<T,U,decltype(ci_pack)::alg_type> pack(variant,ci_pack);
+        qr_type::info<T,U,typename decltype(ci_pack)::alg_type> pack(variant,ci_pack);
 
+        // Repeated factorizations must reuse the summa workspace rather than grow it
+        size_t workspace_bytes = 0;
         for (size_t k=0; k<num_iter; k++){
-          A.distribute_random(RectTopo.x, RectTopo.y, RectTopo.c, RectTopo.d, rank/RectTopo.c);
+          reset();
           PMPI_Barrier(MPI_COMM_WORLD);
           qr_type::factor(A, pack, RectTopo);
+          if (k==0) workspace_bytes = matmult::workspace::num_bytes();
+          else if (matmult::workspace::num_bytes() != workspace_bytes){
+            std::cout << "summa workspace grew from " << workspace_bytes << " to " << matmult::workspace::num_bytes() << " bytes across repeated factorizations\n";
+            MPI_Abort(MPI_COMM_WORLD,-1);
+          }
         }
-        A.distribute_random(RectTopo.x, RectTopo.y, RectTopo.c, RectTopo.d, rank/RectTopo.c);
+        reset(); serialize_stats::reset();
         PMPI_Barrier(MPI_COMM_WORLD);
         auto start_time = MPI_Wtime();
         qr_type::factor(A, pack, RectTopo);
 	auto end_time = MPI_Wtime() - start_time;
         PMPI_Allreduce(MPI_IN_PLACE,&end_time,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
-        if (rank == 0) std::cout << num_rows << " " << num_columns << " " << i << " " << j << " " << end_time << std::endl;
+        // last column: bytes copied by serialize on rank 0 during the timed factorization
+        if (rank == 0) std::cout << num_rows << " " << num_columns << " " << i << " " << j << " " << end_time << " " << serialize_stats::bytes() << std::endl;
 
-        A.distribute_random(RectTopo.x, RectTopo.y, RectTopo.c, RectTopo.d, rank/RectTopo.c);
+        reset();
 #ifdef CRITTER
         critter::start();
 #endif
@@ -63,8 +83,8 @@ int main(int argc, char** argv){
 #endif
 /*
       qr_type::factor(A, pack, RectTopo);
-      auto residual_local = qr::validate<qr_type>::residual(A,pack,RectTopo);
-      auto orthogonality_local = qr::validate<qr_type>::orthogonality(A,pack,RectTopo);
+      R residual_local = std::abs(qr::validate<qr_type>::residual(A,pack,RectTopo));
+      R orthogonality_local = std::abs(qr::validate<qr_type>::orthogonality(A,pack,RectTopo));
       MPI_Reduce(&residual_local,&residual_error,1,mpi_dtype,MPI_MAX,0,MPI_COMM_WORLD);
       MPI_Reduce(&orthogonality_local,&orthogonality_error,1,mpi_dtype,MPI_MAX,0,MPI_COMM_WORLD);
       if (rank==0){ std::cout << residual_error << " " << orthogonality_error << std::endl; }
@@ -72,6 +92,19 @@ int main(int argc, char** argv){
       }
     }
   }
+}
+
+int main(int argc, char** argv){
+  int rank,size,provided; MPI_Init_thread(&argc,&argv,MPI_THREAD_SERIALIZED,&provided);
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank); MPI_Comm_size(MPI_COMM_WORLD,&size);
+  if (rank==0) std::cout << "backend - " << blas::engine::backend::name() << " - threads - " << blas::engine::backend::get_num_threads() << std::endl;
+
+  size_t precision = argc > 15 ? atoi(argv[15]) : 1;// scalar type (0 - float, 1 - double, 2 - complex<float>, 3 - complex<double>)
+  switch (precision){
+    case 0: run<float>(argc,argv,rank,size); break;
+    case 1: run<double>(argc,argv,rank,size); break;
+    case 2: run<std::complex<float>>(argc,argv,rank,size); break;
+    case 3: run<std::complex<double>>(argc,argv,rank,size); break;
+  }
   MPI_Finalize();
-  return 0;
 }
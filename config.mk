@@ -1,16 +1,24 @@
 BIN=$(HOME)/capital/bin/
 
+## BLAS/LAPACK backend: MKL, OPENBLAS, BLIS or NETLIB (reference CBLAS and LAPACKE)
+BACKEND=MKL
+#BACKEND_LIBS=-mkl=parallel
+#BACKEND_LIBS=-lopenblas
+#BACKEND_LIBS=-lblis -llapacke -llapack
+#BACKEND_LIBS=-lcblas -llapacke -llapack -lblas
+BACKEND_LIBS=
+
 ## For Stampede2
 #critter_dir=$(HOME)/critter
 #CCMPI=mpicxx
 CCMPI=
 #INCLUDES=-I$(critter_dir)/include
 INCLUDES=
-#DEFS=-DMKL -DCRITTER -DALGORITHMIC_SYMBOLS
-DEFS=
-#CFLAGS=-g -Wall -O3 -std=c++14 -mkl=parallel -xMIC-AVX512 ${DEFS} ${INCLUDES}
+#DEFS=-D$(BACKEND) -DCRITTER -DALGORITHMIC_SYMBOLS -DFIRST_TOUCH
+DEFS=-D$(BACKEND)
+#CFLAGS=-g -Wall -O3 -std=c++14 -qopenmp -mkl=parallel -xMIC-AVX512 ${DEFS} ${INCLUDES}
 CFLAGS=${DEFS} ${INCLUDES}
 #LIB_PATH=-L$(critter_dir)/lib
 LIB_PATH=
-#LIBS=-lcritter
-LIBS=
+#LIBS=-lcritter $(BACKEND_LIBS)
+LIBS=$(BACKEND_LIBS)
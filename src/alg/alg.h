@@ -15,6 +15,7 @@ class OffloadImmediate;	// Immediately offload matrix data to GPU and keep it re
 #include "./../blas/engine.h"
 #include "./../lapack/engine.h"
 #include "./../matrix/matrix.h"
+#include "./../matrix/view.h"
 #include "./../matrix/serialize.h"
 #include "./../util/topology.h"
 #include "./../util/util.h"
@@ -20,6 +20,7 @@ public:
     using DimensionType = DimensionType;
     using alg_type = cholinv<SerializePolicy,IntermediatesPolicy,BaseCasePolicy>;
     using SP = SerializePolicy; using IP = IntermediatesPolicy; using BP = BaseCasePolicy;
+    using BaseCaseStructure = typename SerializePolicy::base_case_structure;
     info(const info& p) : complete_inv(p.complete_inv), split(p.split), bc_mult_dim(p.bc_mult_dim), dir(p.dir) {}
     info(info&& p) : complete_inv(p.complete_inv), split(p.split), bc_mult_dim(p.bc_mult_dim), dir(p.dir) {}
     info(DimensionType complete_inv, DimensionType split, DimensionType bc_mult_dim, char dir) : complete_inv(complete_inv), split(split), bc_mult_dim(bc_mult_dim), dir(dir) {}
@@ -32,12 +33,12 @@ public:
     matrix<ScalarType,DimensionType,typename SerializePolicy::structure> R;
     matrix<ScalarType,DimensionType,typename SerializePolicy::structure> Rinv;
     // Optimizing members
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,typename SerializePolicy::structure>> policy_table;
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect>> rect_table1;
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect>> rect_table2;
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,typename SerializePolicy::structure>> base_case_table;
+    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,typename SerializePolicy::structure,OffloadEachGemm,typename IntermediatesPolicy::allocator>> policy_table;
+    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect,OffloadEachGemm,typename IntermediatesPolicy::allocator>> rect_table1;
+    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect,OffloadEachGemm,typename IntermediatesPolicy::allocator>> rect_table2;
+    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,BaseCaseStructure,OffloadEachGemm,typename IntermediatesPolicy::allocator>> base_case_table;
     std::map<std::pair<DimensionType,DimensionType>,std::vector<ScalarType>> base_case_blocked_table;
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect>> base_case_cyclic_table;
+    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect,OffloadEachGemm,typename IntermediatesPolicy::allocator>> base_case_cyclic_table;
     DimensionType localDimension,globalDimension,trueLocalDimension,trueGlobalDimension,bcDimension;
     DimensionType AstartX,AendX,AstartY,AendY,TIstartX,TIendX,TIstartY,TIendY;
     MPI_Request req;
@@ -24,6 +24,7 @@ void cholinv<SerializePolicy,IntermediatesPolicy,BaseCasePolicy>::factor(const M
   args.localDimension=localDimension; args.trueLocalDimension=localDimension; args.globalDimension=globalDimension; args.trueGlobalDimension=globalDimension; args.bcDimension=bcDimension;
   args.AstartX=0; args.AendX=localDimension; args.AstartY=0; args.AendY=localDimension; args.TIstartX=0; args.TIendX=localDimension; args.TIstartY=0; args.TIendY=localDimension;
   invoke(args, std::forward<CommType>(CommInfo));
+  serialize_plan::clear();
   CRITTER_STOP(CI::factor);
 }
 
@@ -114,13 +115,16 @@ void cholinv<SerializePolicy,IntermediatesPolicy,BaseCasePolicy>::invoke(ArgType
   CRITTER_START(CI::trsm);
 #endif
   serialize<uppertri,uppertri>::invoke(args.Rinv, IP::invoke(args.policy_table,std::make_pair(split1,split1)), args.TIstartX, args.TIstartX+split1, args.TIstartY, args.TIstartY+split1,0,split1,0,split1);
-  util::transpose(IP::invoke(args.policy_table,std::make_pair(split1,split1)), std::forward<CommType>(CommInfo));
+  // The exchange with the transpose partner overlaps the serialization of R12
+  auto transposeRequest = util::transpose_start(IP::invoke(args.policy_table,std::make_pair(split1,split1)), std::forward<CommType>(CommInfo));
   blas::ArgPack_trmm<T> trmmArgs(blas::Order::AblasColumnMajor, blas::Side::AblasLeft, blas::UpLo::AblasUpper, blas::Transpose::AblasTrans, blas::Diag::AblasNonUnit, 1.);
 
-  serialize<rect,rect>::invoke(args.R, IP::invoke(args.rect_table1,std::make_pair(split2,split1)), args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1,0,split2,0,split1);
-  matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split1,split1)), IP::invoke(args.rect_table1,std::make_pair(split2,split1)), std::forward<CommType>(CommInfo), trmmArgs);
-  serialize<rect,rect>::invoke(IP::invoke(args.rect_table1,std::make_pair(split2,split1)), args.R, 0,split2,0,split1,args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1);
-  serialize<rect,rect>::invoke(IP::invoke(args.rect_table1,std::make_pair(split2,split1)), IP::invoke(args.rect_table2,std::make_pair(split2,split1)),0,split2,0,split1,0,split2,0,split1);
+  auto&& R12 = SP::rect_block(args.R, args.R, IP::invoke(args.rect_table1,std::make_pair(split2,split1)), args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1,
+                               args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1);
+  util::transpose_finish(transposeRequest, IP::invoke(args.policy_table,std::make_pair(split1,split1)));
+  matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split1,split1)), R12, std::forward<CommType>(CommInfo), trmmArgs);
+  SP::rect_unblock(R12, args.R, args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1);
+  serialize<rect,rect>::invoke(args.R, IP::invoke(args.rect_table2,std::make_pair(split2,split1)), args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1,0,split2,0,split1);
 #ifdef ALGORITHMIC_SYMBOLS
   CRITTER_STOP(CI::trsm);
 #endif
@@ -130,7 +134,7 @@ void cholinv<SerializePolicy,IntermediatesPolicy,BaseCasePolicy>::invoke(ArgType
 #endif
   blas::ArgPack_syrk<T> syrkArgs(blas::Order::AblasColumnMajor, blas::UpLo::AblasUpper, blas::Transpose::AblasTrans, -1., 1.);
   serialize<uppertri,uppertri>::invoke(args.R, IP::invoke(args.policy_table,std::make_pair(split2,split2)), args.AstartX+split1, args.AendX, args.AstartY+split1, args.AendY,0,split2,0,split2);
-  matmult::summa::invoke(IP::invoke(args.rect_table1,std::make_pair(split2,split1)), IP::invoke(args.rect_table2,std::make_pair(split2,split1)), IP::invoke(args.policy_table,std::make_pair(split2,split2)), std::forward<CommType>(CommInfo), syrkArgs);
+  matmult::summa::invoke(R12, IP::invoke(args.rect_table2,std::make_pair(split2,split1)), IP::invoke(args.policy_table,std::make_pair(split2,split2)), std::forward<CommType>(CommInfo), syrkArgs);
   serialize<uppertri,uppertri>::invoke(IP::invoke(args.policy_table,std::make_pair(split2,split2)), args.R, 0,split2,0,split2,args.AstartX+split1, args.AendX, args.AstartY+split1, args.AendY);
 #ifdef ALGORITHMIC_SYMBOLS
   CRITTER_STOP(CI::tmu);
@@ -145,14 +149,15 @@ void cholinv<SerializePolicy,IntermediatesPolicy,BaseCasePolicy>::invoke(ArgType
   CRITTER_START(CI::tmu);
 #endif
   if (!(!args.complete_inv && (args.globalDimension==args.trueGlobalDimension))){
-    serialize<rect,rect>::invoke(args.R, IP::invoke(args.rect_table1,std::make_pair(split2,split1)), args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1,0,split2,0,split1);
+    auto&& Rinv12 = SP::rect_block(args.R, args.Rinv, IP::invoke(args.rect_table1,std::make_pair(split2,split1)), args.AstartX+split1, args.AendX, args.AstartY, args.AstartY+split1,
+                                   args.TIstartX+split1, args.TIendX, args.TIstartY, args.TIstartY+split1);
     serialize<uppertri,uppertri>::invoke(args.Rinv, IP::invoke(args.policy_table,std::make_pair(split1,split1)), args.TIstartX, args.TIstartX+split1, args.TIstartY, args.TIstartY+split1,0,split1,0,split1);
     blas::ArgPack_trmm<T> invPackage1(blas::Order::AblasColumnMajor, blas::Side::AblasLeft, blas::UpLo::AblasUpper, blas::Transpose::AblasNoTrans, blas::Diag::AblasNonUnit, 1.);
-    matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split1,split1)), IP::invoke(args.rect_table1,std::make_pair(split2,split1)), std::forward<CommType>(CommInfo), invPackage1);
+    matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split1,split1)), Rinv12, std::forward<CommType>(CommInfo), invPackage1);
     invPackage1.alpha = -1.; invPackage1.side = blas::Side::AblasRight;
     serialize<uppertri,uppertri>::invoke(args.Rinv, IP::invoke(args.policy_table,std::make_pair(split2,split2)), args.TIstartX+split1, args.TIendX, args.TIstartY+split1, args.TIendY,0,split2,0,split2);
-    matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split2,split2)), IP::invoke(args.rect_table1,std::make_pair(split2,split1)), std::forward<CommType>(CommInfo), invPackage1);
-    serialize<rect,rect>::invoke(IP::invoke(args.rect_table1,std::make_pair(split2,split1)), args.Rinv,0,split2,0,split1,args.TIstartX+split1, args.TIendX, args.TIstartY, args.TIstartY+split1);
+    matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split2,split2)), Rinv12, std::forward<CommType>(CommInfo), invPackage1);
+    SP::rect_unblock(Rinv12, args.Rinv, args.TIstartX+split1, args.TIendX, args.TIstartY, args.TIstartY+split1);
   }
 #ifdef ALGORITHMIC_SYMBOLS
   CRITTER_STOP(CI::tmu);
@@ -9,17 +9,54 @@ namespace cholinv{
 class Serialize{
 protected:
   using structure = uppertri;
+  using base_case_structure = uppertri;	// layout gathered by the base case
+
+  // Rectangular sub-blocks of packed factors have no leading dimension, so they are serialized into an intermediate and back
+  template<typename SrcType, typename HomeType, typename BlockType, typename DimensionType>
+  static BlockType& rect_block(const SrcType& src, HomeType& home, BlockType& block, DimensionType ssx, DimensionType sex, DimensionType ssy, DimensionType sey,
+                               DimensionType hsx, DimensionType hex, DimensionType hsy, DimensionType hey){
+    serialize<rect,rect>::invoke(src,block,ssx,sex,ssy,sey,0,sex-ssx,0,sey-ssy);
+    return block;
+  }
+
+  template<typename BlockType, typename HomeType, typename DimensionType>
+  static void rect_unblock(BlockType& block, HomeType& home, DimensionType hsx, DimensionType hex, DimensionType hsy, DimensionType hey){
+    serialize<rect,rect>::invoke(block,home,0,hex-hsx,0,hey-hsy,hsx,hex,hsy,hey);
+  }
+};
+
+// Factors are stored in Rectangular Full Packed format, so trmm and syrk run on the packed storage without expanding it into a pad.
+//   The base case still gathers the packed columns of Serialize.
+class SerializeRFP : public Serialize{
+protected:
+  using structure = rfp;
 };
 
 class NoSerialize{
 protected:
   using structure = rect;
+  using base_case_structure = rect;
+
+  // Factors are stored as rect, so a sub-block is operated on in place through a view of its home
+  template<typename SrcType, typename HomeType, typename BlockType, typename DimensionType>
+  static view<typename HomeType::ScalarType,typename HomeType::DimensionType,typename HomeType::AllocatorType> rect_block(const SrcType& src, HomeType& home, BlockType& block, DimensionType ssx, DimensionType sex, DimensionType ssy, DimensionType sey,
+                                                                                                                          DimensionType hsx, DimensionType hex, DimensionType hsy, DimensionType hey){
+    if (((void*)&src != (void*)&home) || (ssx != hsx) || (ssy != hsy)){ serialize<rect,rect>::invoke(src,home,ssx,sex,ssy,sey,hsx,hex,hsy,hey); }
+    return view<typename HomeType::ScalarType,typename HomeType::DimensionType,typename HomeType::AllocatorType>(home,hsx,hex,hsy,hey);
+  }
+
+  template<typename BlockType, typename HomeType, typename DimensionType>
+  static void rect_unblock(BlockType& block, HomeType& home, DimensionType hsx, DimensionType hex, DimensionType hsy, DimensionType hey){}
 };
 // ***********************************************************************************************************************************************************************
 
 // ***********************************************************************************************************************************************************************
 class SaveIntermediates{
 protected:
+  // Saved buffers live as long as the args that own them; pooling them lets the next factorization of the same shape reuse them
+  //   (PoolAllocator::release returns them to the system)
+  using allocator = PoolAllocator;
+
   template<typename TableType, typename KeyType, typename... ValueTypes>
   static void init(TableType& table, KeyType&& key, ValueTypes&&... values){
     if (table.find(key) == table.end()){
@@ -84,6 +121,9 @@ protected:
 
 class FlushIntermediates{
 protected:
+  // Flushed buffers go straight back to the system, so the peak footprint stays that of the current recursion level
+  using allocator = StandardAllocator;
+
   template<typename TableType, typename KeyType, typename... ValueTypes>
   static void init(TableType& table, KeyType&& key, ValueTypes&&... values){
     if (table.find(key) == table.end()){
@@ -154,9 +194,61 @@ protected:
     }
   }
 };
+
+// Out-of-core variant of FlushIntermediates: trailing-block intermediates live in file-backed mappings that are unmapped as soon as
+//   each recursion level flushes them, so only the blocks of the current level need to be resident
+class StreamIntermediates : public FlushIntermediates{
+protected:
+  using allocator = MappedAllocator;
+};
 // ***********************************************************************************************************************************************************************
 
 // ***********************************************************************************************************************************************************************
+// Send buffer of a base-case gather. A packed base case is described in place inside args.R by a cached datatype, whereas a rect base case
+//   also carries the zeros below the diagonal and so is still staged through its table.
+template<typename ArgType>
+void base_case_source(ArgType& args, typename ArgType::ScalarType*& buffer, int& count, MPI_Datatype& type){
+  using ArgTypeRR = typename std::remove_reference<ArgType>::type; using T = typename ArgTypeRR::ScalarType;
+  auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY);
+  if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
+    buffer = args.R.data(); count = 1; type = mpi_subtype<T>::triangle(args.R, args.AstartX, args.AendX, args.AstartY, args.AendY, 0, 'U');
+  } else{
+    serialize<uppertri,uppertri>::invoke(args.R, args.base_case_table[index_pair], args.AstartX, args.AendX, args.AstartY, args.AendY,0,index_pair.first,0,index_pair.second);
+    buffer = args.base_case_table[index_pair].data(); count = args.base_case_table[index_pair].num_elems(); type = mpi_type<T>::type;
+  }
+}
+
+// Local R = chol(A), in place in R, and Rinv = R^{-1} of order n, with leading dimension ld; only upper triangles are read or written.
+//   Above the leaf order the factorization recurses on halves. Once R12 = R11^{-H}*A12 is known, the trailing update A22 -= R12^H*R12
+//   and the partial inverse Rinv12 = Rinv11*R12 are independent, so they are dispatched together as one batch.
+template<typename T>
+void base_case_factor(T* R, T* Rinv, int64_t n, int64_t ld){
+  constexpr int64_t leaf_order = 64;
+  if (n <= leaf_order){
+    lapack::ArgPack_potrf potrfArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper);
+    lapack::ArgPack_trtri trtriArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper, lapack::Diag::AlapackNonUnit);
+    lapack::engine::_potrf(R,n,ld,potrfArgs);
+    for (int64_t j=0; j<n; j++){ std::memcpy(Rinv+j*ld, R+j*ld, sizeof(T)*(j+1)); }
+    lapack::engine::_trtri(Rinv,n,ld,trtriArgs);
+    return;
+  }
+  int64_t n1 = n/2; int64_t n2 = n-n1;
+  T* R12 = R+n1*ld; T* R22 = R+n1*ld+n1; T* Rinv12 = Rinv+n1*ld; T* Rinv22 = Rinv+n1*ld+n1;
+  base_case_factor(R, Rinv, n1, ld);
+  blas::ArgPack_trmm<T> solvePack(blas::Order::AblasColumnMajor, blas::Side::AblasLeft, blas::UpLo::AblasUpper, blas::Transpose::AblasTrans, blas::Diag::AblasNonUnit, 1.);
+  blas::engine::_trmm(Rinv, R12, n1, n2, ld, ld, solvePack);
+  for (int64_t j=0; j<n2; j++){ std::memcpy(Rinv12+j*ld, R12+j*ld, sizeof(T)*n1); }
+  blas::ArgPack_gemm<T> updatePack(blas::Order::AblasColumnMajor, blas::Transpose::AblasTrans, blas::Transpose::AblasNoTrans, -1., 1.);
+  blas::ArgPack_trmm<T> inversePack(blas::Order::AblasColumnMajor, blas::Side::AblasLeft, blas::UpLo::AblasUpper, blas::Transpose::AblasNoTrans, blas::Diag::AblasNonUnit, 1.);
+  blas::batch<T> products;
+  products.gemm(R12, R12, R22, n2, n2, n1, ld, ld, ld, updatePack);
+  products.trmm(Rinv, Rinv12, n1, n2, ld, ld, inversePack);
+  products.flush();
+  base_case_factor(R22, Rinv22, n2, ld);
+  inversePack.side = blas::Side::AblasRight; inversePack.alpha = -1.;
+  blas::engine::_trmm(Rinv22, Rinv12, n1, n2, ld, ld, inversePack);
+}
+
 class ReplicateCommComp{
 protected:
   static size_t get_id(){return 0;}
@@ -169,13 +261,13 @@ protected:
     using ArgTypeRR = typename std::remove_reference<ArgType>::type; using T = typename ArgType::ScalarType;
     auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY); auto aggregDim = index_pair.first*CommInfo.d;
     auto localDimension = args.base_case_table[index_pair].num_columns_local();
-    serialize<uppertri,uppertri>::invoke(args.R, args.base_case_table[index_pair], args.AstartX, args.AendX, args.AstartY, args.AendY,0,index_pair.first,0,index_pair.second);
+    T* sendbuf; int sendcount; MPI_Datatype sendtype; base_case_source(args,sendbuf,sendcount,sendtype);
 #ifdef COLLECTIVE_CONCURRENCY_SOLO
     if (CommInfo.z==0)
 #endif
-    MPI_Allgather(args.base_case_table[index_pair].data(), args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, &args.base_case_blocked_table[index_pair][0],
+    MPI_Allgather(sendbuf, sendcount, sendtype, &args.base_case_blocked_table[index_pair][0],
                   args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, CommInfo.slice);
-    if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+    if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
       util::block_to_cyclic_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].data(),
                                      args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
     } else{
@@ -194,11 +286,8 @@ protected:
     using ArgTypeRR = typename std::remove_reference<ArgType>::type; using T = typename ArgType::ScalarType;
     auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY); auto aggregDim = index_pair.first*CommInfo.d;
     auto span = (args.AendX!=args.trueLocalDimension ? aggregDim :aggregDim-(args.trueLocalDimension*CommInfo.d-args.trueGlobalDimension));
-    lapack::ArgPack_potrf potrfArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper);
-    lapack::ArgPack_trtri trtriArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper, lapack::Diag::AlapackNonUnit);
-    lapack::engine::_potrf(args.base_case_cyclic_table[index_pair].data(),span,aggregDim,potrfArgs);
     std::memcpy(args.base_case_cyclic_table[index_pair].scratch(),args.base_case_cyclic_table[index_pair].data(),sizeof(T)*args.base_case_cyclic_table[index_pair].num_elems());
-    lapack::engine::_trtri(args.base_case_cyclic_table[index_pair].scratch(),span,aggregDim,trtriArgs);
+    base_case_factor(args.base_case_cyclic_table[index_pair].data(),args.base_case_cyclic_table[index_pair].scratch(),span,aggregDim);
 #ifdef FUNCTION_SYMBOLS
     CRITTER_STOP(CI::RCC::compute);
 #endif
@@ -236,10 +325,10 @@ protected:
     auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY); auto aggregDim = index_pair.first*CommInfo.d;
     auto localDimension = args.base_case_table[index_pair].num_columns_local();
     if (CommInfo.z==0){
-      serialize<uppertri,uppertri>::invoke(args.R, args.base_case_table[index_pair], args.AstartX, args.AendX, args.AstartY, args.AendY,0,index_pair.first,0,index_pair.second);
-      MPI_Allgather(args.base_case_table[index_pair].data(), args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, &args.base_case_blocked_table[index_pair][0],
+      T* sendbuf; int sendcount; MPI_Datatype sendtype; base_case_source(args,sendbuf,sendcount,sendtype);
+      MPI_Allgather(sendbuf, sendcount, sendtype, &args.base_case_blocked_table[index_pair][0],
                     args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, CommInfo.slice);
-      if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+      if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
         util::block_to_cyclic_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].data(),
                                        args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
       } else{
@@ -260,11 +349,8 @@ protected:
     if (CommInfo.z==0){
       auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY); auto aggregDim = index_pair.first*CommInfo.d;
       auto span = (args.AendX!=args.trueLocalDimension ? aggregDim :aggregDim-(args.trueLocalDimension*CommInfo.d-args.trueGlobalDimension));
-      lapack::ArgPack_potrf potrfArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper);
-      lapack::ArgPack_trtri trtriArgs(lapack::Order::AlapackColumnMajor, lapack::UpLo::AlapackUpper, lapack::Diag::AlapackNonUnit);
-      lapack::engine::_potrf(args.base_case_cyclic_table[index_pair].data(),span,aggregDim,potrfArgs);
       std::memcpy(args.base_case_cyclic_table[index_pair].scratch(),args.base_case_cyclic_table[index_pair].data(),sizeof(T)*args.base_case_cyclic_table[index_pair].num_elems());
-      lapack::engine::_trtri(args.base_case_cyclic_table[index_pair].scratch(),span,aggregDim,trtriArgs);
+      base_case_factor(args.base_case_cyclic_table[index_pair].data(),args.base_case_cyclic_table[index_pair].scratch(),span,aggregDim);
     }
 #ifdef FUNCTION_SYMBOLS
     CRITTER_STOP(CI::RC::compute);
@@ -317,11 +403,11 @@ protected:
     auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY); auto aggregDim = index_pair.first*CommInfo.d;
     auto localDimension = args.base_case_table[index_pair].num_columns_local();
     if (CommInfo.z==0){
-      serialize<uppertri,uppertri>::invoke(args.R, args.base_case_table[index_pair], args.AstartX, args.AendX, args.AstartY, args.AendY,0,index_pair.first,0,index_pair.second);
+      T* sendbuf; int sendcount; MPI_Datatype sendtype; base_case_source(args,sendbuf,sendcount,sendtype);
       if (CommInfo.x==0 && CommInfo.y==0){
-        MPI_Gather(args.base_case_table[index_pair].data(), args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, &args.base_case_blocked_table[index_pair][0],
+        MPI_Gather(sendbuf, sendcount, sendtype, &args.base_case_blocked_table[index_pair][0],
                    args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, 0, CommInfo.slice);
-        if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+        if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
           util::block_to_cyclic_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].data(),
                                          args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
         } else{
@@ -329,7 +415,7 @@ protected:
         }
       }
       else{
-        MPI_Gather(args.base_case_table[index_pair].data(), args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, nullptr, 0, mpi_type<T>::type, 0, CommInfo.slice);
+        MPI_Gather(sendbuf, sendcount, sendtype, nullptr, 0, mpi_type<T>::type, 0, CommInfo.slice);
       }
     }
 #ifdef FUNCTION_SYMBOLS
@@ -352,7 +438,7 @@ protected:
       if (CommInfo.x==0 && CommInfo.y==0){
         lapack::engine::_potrf(args.base_case_cyclic_table[index_pair].data(),span,aggregDim,potrfArgs);
         std::memcpy(args.base_case_cyclic_table[index_pair].scratch(),args.base_case_cyclic_table[index_pair].data(),sizeof(T)*args.base_case_cyclic_table[index_pair].num_elems());
-        if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+        if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
           util::cyclic_to_block_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].data(),
                                          args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
         } else{
@@ -365,7 +451,7 @@ protected:
       }
       if (CommInfo.x==0 && CommInfo.y==0){
         lapack::engine::_trtri(args.base_case_cyclic_table[index_pair].scratch(),span,aggregDim,trtriArgs);
-        if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+        if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
           util::cyclic_to_block_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].scratch(),
                                          args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
         } else{
@@ -426,11 +512,11 @@ protected:
     auto index_pair = std::make_pair(args.AendX-args.AstartX,args.AendY-args.AstartY); auto aggregDim = index_pair.first*CommInfo.d;
     auto localDimension = args.base_case_table[index_pair].num_columns_local();
     if (CommInfo.z==0){
-      serialize<uppertri,uppertri>::invoke(args.R, args.base_case_table[index_pair], args.AstartX, args.AendX, args.AstartY, args.AendY,0,index_pair.first,0,index_pair.second);
+      T* sendbuf; int sendcount; MPI_Datatype sendtype; base_case_source(args,sendbuf,sendcount,sendtype);
       if (CommInfo.x==0 && CommInfo.y==0){
-        MPI_Gather(args.base_case_table[index_pair].data(), args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, &args.base_case_blocked_table[index_pair][0],
+        MPI_Gather(sendbuf, sendcount, sendtype, &args.base_case_blocked_table[index_pair][0],
                    args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, 0, CommInfo.slice);
-        if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+        if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
           util::block_to_cyclic_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].data(),
                                          args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
         } else{
@@ -438,7 +524,7 @@ protected:
         }
       }
       else{
-        MPI_Gather(args.base_case_table[index_pair].data(), args.base_case_table[index_pair].num_elems(), mpi_type<T>::type, nullptr, 0, mpi_type<T>::type, 0, CommInfo.slice);
+        MPI_Gather(sendbuf, sendcount, sendtype, nullptr, 0, mpi_type<T>::type, 0, CommInfo.slice);
       }
     }
 #ifdef FUNCTION_SYMBOLS
@@ -461,7 +547,7 @@ protected:
       if (CommInfo.x==0 && CommInfo.y==0){
         lapack::engine::_potrf(args.base_case_cyclic_table[index_pair].data(),span,aggregDim,potrfArgs);
         std::memcpy(args.base_case_cyclic_table[index_pair].scratch(),args.base_case_cyclic_table[index_pair].data(),sizeof(T)*args.base_case_cyclic_table[index_pair].num_elems());
-        if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+        if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
           util::cyclic_to_block_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].data(),
                                          args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
         } else{
@@ -475,7 +561,7 @@ protected:
       if (CommInfo.x==0 && CommInfo.y==0){
         lapack::engine::_trtri(args.base_case_cyclic_table[index_pair].scratch(),span,aggregDim,trtriArgs);
         MPI_Wait(&args.req,&st);
-        if (std::is_same<typename ArgTypeRR::SP,Serialize>::value){
+        if (std::is_same<typename ArgTypeRR::BaseCaseStructure,uppertri>::value){
           util::cyclic_to_block_triangle(&args.base_case_blocked_table[index_pair][0], args.base_case_cyclic_table[index_pair].scratch(),
                                          args.base_case_blocked_table[index_pair].size(), localDimension, localDimension, CommInfo.d);
         } else{
@@ -0,0 +1,58 @@
+/* Author: Edward Hutter */
+
+#ifndef GENERATE__SPECTRUM_H_
+#define GENERATE__SPECTRUM_H_
+
+#include "./../../alg.h"
+#include "./../../matmult/summa/summa.h"
+
+namespace generate{
+
+// Distribution of the singular values between sigma_0 = 1 and sigma_{n-1} = 1/kappa
+enum class distribution : unsigned char{
+  geometric = 0x0,	// sigma_k = kappa^{-k/(n-1)}
+  arithmetic = 0x1,	// sigma_k = 1 - (k/(n-1))*(1-1/kappa)
+  clustered = 0x2	// sigma_k = 1 for k < n-1
+};
+
+/*
+  Generates A = U*diag(sigma)*V^T with a prescribed singular value distribution and condition number kappa.
+    U and V are random butterflies: a product of ceil(log2(dim)) levels, where level l rotates every pair of indices that differ only in bit l
+    by a random angle (an index whose partner lies beyond dim is left fixed). The result is dense and orthogonal with no low-rank structure,
+    yet an element has exactly one nonzero path through the levels, so every element of U,V is an O(log dim) function of its global
+    coordinates and both factors are generated locally (via philox) without communication. The product is formed with summa.
+    The matrix is distributed exactly as distribute_random would distribute it: (localPgridX,localPgridY,globalPgridX,globalPgridY).
+    CommInfo is the square topology on which summa runs: the same topology for square matrices, and topo::square(RectTopo.cube,RectTopo.c)
+    for tall-skinny matrices distributed on a topo::rect.
+    If symmetric, V = U and A is symmetric positive definite with eigenvalues sigma.
+    U and V are real for every ScalarType, so complex matrices are generated with zero imaginary parts (and are then Hermitian when symmetric).
+*/
+class spectrum{
+public:
+  template<typename MatrixType, typename CommType>
+  static void invoke(MatrixType& A, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, CommType&& CommInfo,
+                     decltype(std::abs(typename MatrixType::ScalarType())) kappa, distribution dist, int64_t key, bool symmetric=false);
+
+  template<typename ScalarType>
+  static ScalarType singular_value(int64_t index, int64_t count, ScalarType kappa, distribution dist);
+
+private:
+  // Random butterfly L_{levels-1}*...*L_0, evaluated one element at a time
+  template<typename ScalarType>
+  class orthogonal{
+  public:
+    orthogonal(int64_t key, int64_t stream, int64_t dim);
+    ScalarType operator()(int64_t row, int64_t column) const;
+  private:
+    int64_t key,stream,dim,levels;
+    ScalarType angle(int64_t level, int64_t pair) const;
+  };
+
+  template<typename MatrixType, typename LambdaType>
+  static void fill(MatrixType& M, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, LambdaType&& Lambda);
+};
+}
+
+#include "spectrum.hpp"
+
+#endif /* GENERATE__SPECTRUM_H_ */
@@ -0,0 +1,102 @@
+/* Author: Edward Hutter */
+
+namespace generate{
+
+template<typename MatrixType, typename CommType>
+void spectrum::invoke(MatrixType& A, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, CommType&& CommInfo,
+                      decltype(std::abs(typename MatrixType::ScalarType())) kappa, distribution dist, int64_t key, bool symmetric){
+#ifdef FUNCTION_SYMBOLS
+  CRITTER_START(Gen::spectrum);
+#endif
+  using T = typename MatrixType::ScalarType; using U = typename MatrixType::DimensionType; using R = decltype(std::abs(T()));
+  static_assert(std::is_same<typename MatrixType::StructureType,rect>::value,"generate::spectrum requires a rect matrix");
+  U globalDimensionM = A.num_rows_global(); U globalDimensionN = A.num_columns_global();
+  assert(globalDimensionM >= globalDimensionN); assert(!symmetric || (globalDimensionM == globalDimensionN));
+
+  // Left factor scaled by the singular values: W = U(:,0:n)*diag(sigma)
+  orthogonal<R> left(key,0,globalDimensionM); orthogonal<R> right(key,symmetric ? 0 : 2,globalDimensionN);
+  std::vector<R> sigma(globalDimensionN);
+  for (U k=0; k<globalDimensionN; k++){ sigma[k] = singular_value(k,globalDimensionN,kappa,dist); }
+  MatrixType W(globalDimensionN,globalDimensionM,globalPgridX,globalPgridY);
+  fill(W,localPgridX,localPgridY,globalPgridX,globalPgridY,[&](U row, U column){ return left(row,column)*sigma[column]; });
+  // Right factor, distributed over the slice of the square topology
+  matrix<T,U,rect,typename MatrixType::OffloadType,typename MatrixType::AllocatorType> Vt(globalDimensionN,globalDimensionN,CommInfo.d,CommInfo.d);
+  fill(Vt,CommInfo.x,CommInfo.y,CommInfo.d,CommInfo.d,[&](U row, U column){ return right(column,row); });
+
+  blas::ArgPack_gemm<T> gemmPack(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasNoTrans, 1., 0.);
+  matmult::summa::invoke(W, Vt, A, std::forward<CommType>(CommInfo), gemmPack);
+
+  if (symmetric){
+    // Remove the rounding asymmetry of U*diag(sigma)*U^T: A = (A + A^T)/2
+    MatrixType At = A; util::transpose(At, std::forward<CommType>(CommInfo));
+    U localDimension = A.num_rows_local();
+    for (U i=0; i<localDimension; i++){
+      for (U j=0; j<localDimension; j++){
+        A.data()[i*localDimension+j] = (A.data()[i*localDimension+j] + conjugate(At.data()[j*localDimension+i]))/T(2.);
+      }
+    }
+  }
+#ifdef FUNCTION_SYMBOLS
+  CRITTER_STOP(Gen::spectrum);
+#endif
+}
+
+template<typename ScalarType>
+ScalarType spectrum::singular_value(int64_t index, int64_t count, ScalarType kappa, distribution dist){
+  if (count == 1){ return 1.; }
+  ScalarType ratio = ScalarType(index)/(count-1);
+  switch (dist){
+    case distribution::geometric:
+      return std::pow(kappa,-ratio);
+    case distribution::arithmetic:
+      return 1. - ratio*(1.-1./kappa);
+    case distribution::clustered:
+      return (index == count-1 ? 1./kappa : 1.);
+  }
+  return 1.;
+}
+
+template<typename ScalarType>
+spectrum::orthogonal<ScalarType>::orthogonal(int64_t key, int64_t stream, int64_t dim) : key(key), stream(stream), dim(dim), levels(0){
+  while ((int64_t(1) << this->levels) < dim){ this->levels++; }
+}
+
+template<typename ScalarType>
+ScalarType spectrum::orthogonal<ScalarType>::operator()(int64_t row, int64_t column) const{
+  // Level l can only change bit l, so the sole path from column to row takes bit l of row at level l
+  ScalarType value = 1.; int64_t index = column;
+  for (int64_t l=0; l<this->levels; l++){
+    int64_t bit = int64_t(1) << l; int64_t next = (index & ~bit) | (row & bit);
+    if ((index | bit) >= this->dim){
+      // unpaired index, fixed by this level
+      if (next != index) return 0.;
+      continue;
+    }
+    ScalarType theta = angle(l,index & ~bit);
+    value *= (next == index ? std::cos(theta) : ((next & bit) ? std::sin(theta) : -std::sin(theta)));
+    index = next;
+  }
+  return value;
+}
+
+template<typename ScalarType>
+ScalarType spectrum::orthogonal<ScalarType>::angle(int64_t level, int64_t pair) const{
+  return 2.*M_PI*philox::_uniform<ScalarType>(this->key,this->stream,level*this->dim+pair);
+}
+
+template<typename MatrixType, typename LambdaType>
+void spectrum::fill(MatrixType& M, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, LambdaType&& Lambda){
+  using U = typename MatrixType::DimensionType;
+  U localDimensionX = M.num_columns_local(); U localDimensionY = M.num_rows_local();
+  U globalDimensionX = M.num_columns_global(); U globalDimensionY = M.num_rows_global();
+  #pragma omp parallel for
+  for (U i=0; i<localDimensionX; i++){
+    U globalPositionX = localPgridX + i*globalPgridX;
+    for (U j=0; j<localDimensionY; j++){
+      U globalPositionY = localPgridY + j*globalPgridY;
+      // zero padding beyond the global dimensions
+      M.data()[i*localDimensionY+j] = ((globalPositionX < globalDimensionX) && (globalPositionY < globalDimensionY)) ? typename MatrixType::ScalarType(Lambda(globalPositionY,globalPositionX)) : typename MatrixType::ScalarType(0.);
+    }
+  }
+}
+}
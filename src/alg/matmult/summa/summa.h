@@ -4,6 +4,7 @@
 #define MATMULT__SUMMA_H_
 
 #include "./../../alg.h"
+#include "./workspace.h"
 
 namespace matmult{
 /*
@@ -27,11 +28,17 @@ public:
   template<typename MatrixAType, typename MatrixBType, typename CommType>
   static void invoke(MatrixAType& A, MatrixBType& B, CommType&& CommInfo, blas::ArgPack_trmm<typename MatrixAType::ScalarType>& srcPackage);
 
+  // B <- alpha*op(A)^{-1}*B or alpha*B*op(A)^{-1}, for any number of right-hand sides, without forming the inverse. A is split recursively
+  //   about its middle: one half of B is solved, the other half is updated with a summa gemm, and then solved. Diagonal blocks of
+  //   global order at most bcDimension (by default the local order over c, times d) are gathered onto each slice and solved locally.
+  template<typename MatrixAType, typename MatrixBType, typename CommType>
+  static void invoke(MatrixAType& A, MatrixBType& B, CommType&& CommInfo, blas::ArgPack_trsm<typename MatrixAType::ScalarType>& srcPackage, int64_t bcDimension=0);
+
   template<typename MatrixSrcType, typename MatrixDestType, typename CommType>
   static void invoke(MatrixSrcType& A, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixSrcType::ScalarType>& srcPackage);
 
-  template<typename MatrixSrcType, typename MatrixDestType, typename CommType>
-  static void invoke(MatrixSrcType& A, MatrixSrcType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixSrcType::ScalarType>& srcPackage);
+  template<typename MatrixAType, typename MatrixBType, typename MatrixDestType, typename CommType>
+  static void invoke(MatrixAType& A, MatrixBType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixAType::ScalarType>& srcPackage);
 
 private:
 
@@ -41,8 +48,82 @@ private:
   template<typename MatrixType, typename CommType>
   static void collect(MatrixType& matrix, CommType&& CommInfo);
 
-  template<typename MatrixSrcType, typename MatrixDestType, typename CommType>
-  static void syrk_internal(MatrixSrcType& A, MatrixSrcType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixSrcType::ScalarType>& srcPackage);
+  template<typename MatrixAType, typename MatrixBType, typename MatrixCType, typename CommType>
+  static void gemm_collect(MatrixAType& A, MatrixBType& B, MatrixCType& C, int64_t m, int64_t n, int64_t k, CommType&& CommInfo, const blas::ArgPack_gemm<typename MatrixAType::ScalarType>& srcPackage);
+
+  template<typename MatrixType, typename CommType>
+  static void attach(MatrixType& matrix, CommType&& CommInfo, size_t slot);
+
+  // Workspace slot of trsm's expanded triangle; attach uses slots 0 through 5
+  static constexpr size_t trsm_slot = 6;
+
+  template<typename MatrixAType, typename MatrixBType, typename MatrixDestType, typename CommType>
+  static void syrk_internal(MatrixAType& A, MatrixBType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixAType::ScalarType>& srcPackage);
+
+  template<typename MatrixAType, typename MatrixBType, typename CommType>
+  static void trsm_internal(MatrixAType& A, MatrixBType& B, int64_t start, int64_t end, CommType&& CommInfo, const blas::ArgPack_trsm<typename MatrixAType::ScalarType>& srcPackage, int64_t bcDimension);
+
+  template<typename MatrixAType, typename MatrixBType, typename CommType>
+  static void trsm_base_case(MatrixAType& A, MatrixBType& B, int64_t start, int64_t end, CommType&& CommInfo, const blas::ArgPack_trsm<typename MatrixAType::ScalarType>& srcPackage);
+
+  template<typename MatrixType>
+  static bool alias(MatrixType& matrix);
+
+  template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+  static bool alias(view<ScalarType,DimensionType,AllocatorPolicy>& matrix);
+
+  template<typename MatrixType>
+  static void stage(MatrixType& matrix);
+
+  template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+  static void stage(view<ScalarType,DimensionType,AllocatorPolicy>& matrix);
+
+  template<typename MatrixType>
+  static void retrieve(MatrixType& matrix, typename MatrixType::ScalarType beta);
+
+  template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+  static void retrieve(view<ScalarType,DimensionType,AllocatorPolicy>& matrix, ScalarType beta);
+
+  template<typename MatrixType>
+  static int64_t leading_dimension(const MatrixType& matrix);
+
+  template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+  static int64_t leading_dimension(const view<ScalarType,DimensionType,AllocatorPolicy>& matrix);
+
+  template<typename MatrixType>
+  static void chunk(MatrixType& matrix, int64_t idx, int64_t num_chunks, typename MatrixType::ScalarType*& buffer, int& count, MPI_Datatype& type);
+
+  template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+  static void chunk(view<ScalarType,DimensionType,AllocatorPolicy>& matrix, int64_t idx, int64_t num_chunks, ScalarType*& buffer, int& count, MPI_Datatype& type);
+
+  template<typename MatrixType>
+  static void clear_complement(MatrixType& matrix);
+
+  template<typename MatrixType>
+  static void source(MatrixType& matrix, int64_t idx, int64_t num_chunks, bool isRoot, typename MatrixType::ScalarType*& buffer, int& count, MPI_Datatype& type);
+
+  template<typename MatrixAType, typename MatrixBType>
+  static void local_trmm(MatrixAType& A, MatrixBType& B, int64_t m, int64_t n, const blas::ArgPack_trmm<typename MatrixAType::ScalarType>& srcPackage);
+
+  template<typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy, typename MatrixBType>
+  static void local_trmm(matrix<ScalarType,DimensionType,rfp,OffloadPolicy,AllocatorPolicy>& A, MatrixBType& B, int64_t m, int64_t n, const blas::ArgPack_trmm<ScalarType>& srcPackage);
+
+  template<typename MatrixAType, typename MatrixBType, typename MatrixCType>
+  static void local_gemm(MatrixAType& A, MatrixBType& B, MatrixCType& C, int64_t n, int64_t k, const blas::ArgPack_gemm<typename MatrixAType::ScalarType>& srcPackage);
+
+  template<typename MatrixAType, typename MatrixBType, typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy>
+  static void local_gemm(MatrixAType& A, MatrixBType& B, matrix<ScalarType,DimensionType,rfp,OffloadPolicy,AllocatorPolicy>& C, int64_t n, int64_t k, const blas::ArgPack_gemm<ScalarType>& srcPackage);
+
+  // Only the stored triangle of a packed triangular C is formed
+  template<typename MatrixAType, typename MatrixBType, typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy>
+  static void local_gemm(MatrixAType& A, MatrixBType& B, matrix<ScalarType,DimensionType,uppertri,OffloadPolicy,AllocatorPolicy>& C, int64_t n, int64_t k, const blas::ArgPack_gemm<ScalarType>& srcPackage);
+
+  template<typename MatrixAType, typename MatrixBType, typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy>
+  static void local_gemm(MatrixAType& A, MatrixBType& B, matrix<ScalarType,DimensionType,lowertri,OffloadPolicy,AllocatorPolicy>& C, int64_t n, int64_t k, const blas::ArgPack_gemm<ScalarType>& srcPackage);
+
+  // Packed triangular operands are expanded into their pad for the local BLAS call; rfp operands are used as stored
+  template<typename StructureType>
+  static constexpr bool expands() { return !std::is_same<StructureType,rect>::value && !std::is_same<StructureType,rfp>::value; }
 };
 }
 
@@ -12,10 +12,13 @@ void summa::invoke(MatrixAType& A, MatrixBType& B, MatrixCType& C, CommType&& Co
   // Also this way, we can take advantage of the new pass-by-value move semantics that are efficient
   using T = typename MatrixAType::ScalarType;
   using StructureA = typename MatrixAType::StructureType; using StructureB = typename MatrixBType::StructureType;
+  static_assert(!std::is_same<StructureA,rfp>::value && !std::is_same<StructureB,rfp>::value,"summa gemm does not accept rfp operands");
 
   bool isRootRow = ((CommInfo.x == CommInfo.z) ? true : false);
   bool isRootColumn = ((CommInfo.y == CommInfo.z) ? true : false);
+  attach(A,std::forward<CommType>(CommInfo),0); attach(B,std::forward<CommType>(CommInfo),1); attach(C,std::forward<CommType>(CommInfo),2);
   if (isRootRow){ A.swap(); } if (isRootColumn){ B.swap(); }
+  bool inplaceC = alias(C);
   auto localDimensionM = (srcPackage.transposeA == blas::Transpose::AblasNoTrans ? A.num_rows_local() : A.num_columns_local());
   auto localDimensionN = (srcPackage.transposeB == blas::Transpose::AblasNoTrans ? B.num_columns_local() : B.num_rows_local());
   auto localDimensionK = (srcPackage.transposeA == blas::Transpose::AblasNoTrans ? A.num_columns_local() : A.num_rows_local());
@@ -24,20 +27,21 @@ void summa::invoke(MatrixAType& A, MatrixBType& B, MatrixCType& C, CommType&& Co
   distribute(A,B,std::forward<CommType>(CommInfo));
 
   // Assume, for now, that C has Rectangular Structure. In the future, we can always do the same procedure as above, and add a invoke after the AllReduce
-  decltype(srcPackage.beta) save_beta = srcPackage.beta; srcPackage.beta = 0;
-  blas::engine::_gemm(A.scratch(), B.scratch(), C.scratch(), localDimensionM, localDimensionN, localDimensionK,
-                      (srcPackage.transposeA == blas::Transpose::AblasNoTrans ? localDimensionM : localDimensionK),
-                      (srcPackage.transposeB == blas::Transpose::AblasNoTrans ? localDimensionK : localDimensionN), localDimensionM, srcPackage);
-  collect(C,std::forward<CommType>(CommInfo));
-  if (save_beta != 0){
-    for (auto i=0; i<C.num_elems(); i++){ C.data()[i] = save_beta*C.data()[i] + C.scratch()[i]; }
+  // An output that is reduced in place has beta applied by a single layer
+  decltype(srcPackage.beta) save_beta = srcPackage.beta; srcPackage.beta = (inplaceC && CommInfo.z==0 ? save_beta : 0);
+  if ((CommInfo.num_chunks == 0) || !std::is_same<typename MatrixCType::StructureType,rect>::value){
+    blas::engine::_gemm(A.scratch(), B.scratch(), C.scratch(), localDimensionM, localDimensionN, localDimensionK,
+                        leading_dimension(A), leading_dimension(B), leading_dimension(C), srcPackage);
+    collect(C,std::forward<CommType>(CommInfo));
   }
-  else{ C.swap(); }
+  else{ gemm_collect(A, B, C, localDimensionM, localDimensionN, localDimensionK, std::forward<CommType>(CommInfo), srcPackage); }
+  retrieve(C,save_beta);
   // Reset before returning
   srcPackage.beta = save_beta;
-  if (!std::is_same<StructureA,rect>::value){ A.swap_pad(); }
-  if (!std::is_same<StructureB,rect>::value){ B.swap_pad(); }
+  if (expands<StructureA>()){ A.swap_pad(); }
+  if (expands<StructureB>()){ B.swap_pad(); }
   if (isRootRow){ A.swap(); } if (isRootColumn){ B.swap(); }
+  A._return_(); B._return_(); C._return_();
 #ifdef FUNCTION_SYMBOLS
   CRITTER_STOP(Summa::invoke);
 #endif
@@ -52,31 +56,76 @@ void summa::invoke(MatrixAType& A, MatrixBType& B, CommType&& CommInfo, blas::Ar
   // Also this way, we can take advantage of the new pass-by-value move semantics that are efficient
   using T = typename MatrixAType::ScalarType;
   using StructureA = typename MatrixAType::StructureType; using StructureB = typename MatrixBType::StructureType;
+  static_assert(!std::is_same<StructureB,rfp>::value,"summa trmm accepts an rfp operand only as the triangular matrix");
 
   bool isRootRow = ((CommInfo.x == CommInfo.z) ? true : false);
   bool isRootColumn = ((CommInfo.y == CommInfo.z) ? true : false);
   auto localDimensionM = B.num_rows_local(); auto localDimensionN = B.num_columns_local();
+  attach(A,std::forward<CommType>(CommInfo),0); attach(B,std::forward<CommType>(CommInfo),1);
 
   // Communicated data lives in the _scratch members of A,B
   if (srcPackage.side == blas::Side::AblasLeft){
-    if (isRootRow){ A.swap(); } if (isRootColumn){ B.swap(); }
+    if (isRootRow){ A.swap(); } if (!alias(B) && isRootColumn){ stage(B); }
     distribute(A, B, std::forward<CommType>(CommInfo));
-    blas::engine::_trmm(A.scratch(), B.scratch(), localDimensionM, localDimensionN, localDimensionM, localDimensionM, srcPackage);
+    local_trmm(A, B, localDimensionM, localDimensionN, srcPackage);
   }
   else{
-    if (isRootRow){ B.swap(); } if (isRootColumn){ A.swap(); }
+    if (!alias(B) && isRootRow){ stage(B); } if (isRootColumn){ A.swap(); }
     distribute(B,A,std::forward<CommType>(CommInfo));
     if (std::is_same<StructureB,uppertri>::value){ B.swap_pad(); util::remove_triangle_local(B,CommInfo.x,CommInfo.y,CommInfo.d,'U'); B.swap_pad(); }
     if (std::is_same<StructureB,lowertri>::value){ B.swap_pad(); util::remove_triangle_local(B,CommInfo.x,CommInfo.y,CommInfo.d,'L'); B.swap_pad(); }
-    blas::engine::_trmm(A.scratch(), B.scratch(), localDimensionM, localDimensionN, localDimensionN, localDimensionM, srcPackage);
+    local_trmm(A, B, localDimensionM, localDimensionN, srcPackage);
   }
   // We will follow the standard here: A is always the triangular matrix. B is always the rectangular matrix
   if (!std::is_same<StructureB,rect>::value){ B.swap_pad(); serialize<StructureB,StructureB>::invoke(B,B,0,localDimensionN,0,localDimensionN,0,localDimensionN,0,localDimensionN,2,1); }
   collect(B,std::forward<CommType>(CommInfo));
   // Reset before returning
-  if (!std::is_same<StructureA,rect>::value){ A.swap_pad(); }
-  if (isRootRow && srcPackage.side == blas::Side::AblasLeft){ A.swap(); }
-  B.swap();	// unconditional swap, since B holds output
+  if (expands<StructureA>()){ A.swap_pad(); }
+  if (srcPackage.side == blas::Side::AblasLeft){ if (isRootRow){ A.swap(); } }
+  else{ if (isRootColumn){ A.swap(); } }
+  retrieve(B,T(0));	// unconditional, since B holds output
+  A._return_(); B._return_();
+#ifdef FUNCTION_SYMBOLS
+  CRITTER_STOP(Summa::invoke);
+#endif
+}
+
+template<typename MatrixAType, typename MatrixBType, typename CommType>
+void summa::invoke(MatrixAType& A, MatrixBType& B, CommType&& CommInfo, blas::ArgPack_trsm<typename MatrixAType::ScalarType>& srcPackage, int64_t bcDimension){
+#ifdef FUNCTION_SYMBOLS
+  CRITTER_START(Summa::invoke);
+#endif
+  using T = typename MatrixAType::ScalarType; using U = typename MatrixAType::DimensionType;
+  using StructureA = typename MatrixAType::StructureType; using StructureB = typename MatrixBType::StructureType;
+  static_assert(std::is_same<StructureB,rect>::value && !is_view<MatrixBType>::value,"summa trsm solves into a rect matrix");
+  assert(srcPackage.order == blas::Order::AblasColumnMajor);
+
+  U localDimension = A.num_rows_local();
+  if (bcDimension <= 0){ bcDimension = std::max(U(1),U(localDimension/CommInfo.c))*CommInfo.d; }
+  // The triangle is expanded once, into the workspace slot after those of attach, and transposed across the grid when op(A) is its
+  //   transpose, so every update below is a NoTrans gemm on views. Entries opposite the triangle are never referenced.
+  U localColumns = A.num_columns_local(); U localRows = A.num_rows_local();
+  matrix<T,U,rect> Aop(workspace::get<T>(CommInfo,trsm_slot,localColumns*localRows),localColumns,localRows,CommInfo.d,CommInfo.d);
+  Aop.set_num_columns_global(A.num_columns_global()); Aop.set_num_rows_global(A.num_rows_global());
+  serialize<StructureA,rect>::invoke(A,Aop,0,localDimension,0,localDimension,0,localDimension,0,localDimension);
+  bool upper = (srcPackage.uplo == blas::UpLo::AblasUpper);
+  if (srcPackage.transposeA == blas::Transpose::AblasTrans){
+    // The partner's block arrives untransposed and is transposed and conjugated in place, which needs a square local block
+    assert(Aop.num_rows_local() == Aop.num_columns_local());
+    util::transpose(Aop,std::forward<CommType>(CommInfo));
+    for (U i=0; i<localDimension; i++){
+      Aop.data()[i*localDimension+i] = conjugate(Aop.data()[i*localDimension+i]);
+      for (U j=i+1; j<localDimension; j++){
+        T temp = Aop.data()[i*localDimension+j];
+        Aop.data()[i*localDimension+j] = conjugate(Aop.data()[j*localDimension+i]); Aop.data()[j*localDimension+i] = conjugate(temp);
+      }
+    }
+    upper = !upper;
+  }
+  if (srcPackage.alpha != T(1)){ for (U i=0; i<B.num_elems(); i++){ B.data()[i] *= srcPackage.alpha; } }
+  blas::ArgPack_trsm<T> trsmArgs(srcPackage.order, srcPackage.side, (upper ? blas::UpLo::AblasUpper : blas::UpLo::AblasLower),
+                                 blas::Transpose::AblasNoTrans, srcPackage.diag, 1.);
+  trsm_internal(Aop, B, 0, localDimension, std::forward<CommType>(CommInfo), trsmArgs, bcDimension);
 #ifdef FUNCTION_SYMBOLS
   CRITTER_STOP(Summa::invoke);
 #endif
@@ -95,8 +144,8 @@ void summa::invoke(MatrixSrcType& A, MatrixDestType& C, CommType&& CommInfo, bla
 #endif
 }
 
-template<typename MatrixSrcType, typename MatrixDestType, typename CommType>
-void summa::invoke(MatrixSrcType& A, MatrixSrcType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixSrcType::ScalarType>& srcPackage){
+template<typename MatrixAType, typename MatrixBType, typename MatrixDestType, typename CommType>
+void summa::invoke(MatrixAType& A, MatrixBType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixAType::ScalarType>& srcPackage){
 #ifdef FUNCTION_SYMBOLS
   CRITTER_START(Summa::invoke);
 #endif
@@ -107,22 +156,24 @@ void summa::invoke(MatrixSrcType& A, MatrixSrcType& B, MatrixDestType& C, CommTy
 #endif
 }
 
-template<typename MatrixSrcType, typename MatrixDestType, typename CommType>
-void summa::syrk_internal(MatrixSrcType& A, MatrixSrcType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixSrcType::ScalarType>& srcPackage){
+template<typename MatrixAType, typename MatrixBType, typename MatrixDestType, typename CommType>
+void summa::syrk_internal(MatrixAType& A, MatrixBType& B, MatrixDestType& C, CommType&& CommInfo, blas::ArgPack_syrk<typename MatrixAType::ScalarType>& srcPackage){
 #ifdef FUNCTION_SYMBOLS
   CRITTER_START(Summa::syrk_int);
 #endif
   // Note: Internally, this routine uses gemm, not syrk, as its not possible for each processor to perform local MM with symmetric matrices
-  //         given the data layout over the processor grid.
+  //         given the data layout over the processor grid. A packed triangular C only keeps the local triangle, so there gemmt forms just that half.
 
-  using T = typename MatrixSrcType::ScalarType;
-  using StructureA = typename MatrixSrcType::StructureType; using StructureC = typename MatrixDestType::StructureType;
+  using T = typename MatrixAType::ScalarType;
+  using StructureA = typename MatrixAType::StructureType; using StructureC = typename MatrixDestType::StructureType;
 
   bool isRootRow = ((CommInfo.x == CommInfo.z) ? true : false);
   bool isRootColumn = ((CommInfo.y == CommInfo.z) ? true : false);
   // Note: The routine will be C <- BA or AB, depending on the order in the srcPackage. B will always be the transposed matrix
   auto localDimensionN = C.num_columns_local();  // rows or columns, doesn't matter. They should be the same. C is meant to be square
   auto localDimensionK = (srcPackage.transposeA == blas::Transpose::AblasNoTrans ? A.num_columns_local() : A.num_rows_local());
+  attach(A,std::forward<CommType>(CommInfo),0); attach(B,std::forward<CommType>(CommInfo),1); attach(C,std::forward<CommType>(CommInfo),2);
+  bool inplaceC = alias(C);
 
   if (srcPackage.transposeA == blas::Transpose::AblasNoTrans){
     if (isRootRow){ A.swap(); } if (isRootColumn){ B.swap(); }
@@ -131,35 +182,122 @@ void summa::syrk_internal(MatrixSrcType& A, MatrixSrcType& B, MatrixDestType& C,
     if (isRootRow){ B.swap(); } if (isRootColumn){ A.swap(); }
     distribute(B,A,std::forward<CommType>(CommInfo)); }
 
-  if (!std::is_same<StructureC,rect>::value) { C.swap_pad(); }
-  for (auto i=0; i<(localDimensionN*localDimensionN); i++) { C.scratch()[i] = 0.; }
+  if (expands<StructureC>()) { C.swap_pad(); }
+  auto outputNumElems = (std::is_same<StructureC,rfp>::value ? C.num_elems() : localDimensionN*localDimensionN);
+  if (!inplaceC){ for (auto i=0; i<outputNumElems; i++) { C.scratch()[i] = 0.; } }
   // This cancels out any affect beta could have. Beta is just not compatable with summa and must be handled separately
+  //   (an output that is reduced in place has beta applied by a single layer instead)
+  T local_beta = (inplaceC ? (CommInfo.z==0 ? srcPackage.beta : 0) : srcPackage.beta);
   if (srcPackage.transposeA == blas::Transpose::AblasNoTrans){
-    blas::ArgPack_gemm<T> gemmArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasTrans, srcPackage.alpha,srcPackage.beta);
-    blas::engine::_gemm(A.scratch(), B.scratch(), C.scratch(), localDimensionN, localDimensionN, localDimensionK,
-                        localDimensionN, localDimensionN, localDimensionN, gemmArgs);
+    blas::ArgPack_gemm<T> gemmArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasTrans, srcPackage.alpha,local_beta);
+    local_gemm(A, B, C, localDimensionN, localDimensionK, gemmArgs);
   }
   else{
-    blas::ArgPack_gemm<T> gemmArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasTrans, blas::Transpose::AblasNoTrans,srcPackage.alpha,srcPackage.beta);
-    blas::engine::_gemm(B.scratch(), A.scratch(), C.scratch(), localDimensionN, localDimensionN, localDimensionK,
-                        localDimensionK, localDimensionK, localDimensionN, gemmArgs);
+    blas::ArgPack_gemm<T> gemmArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasTrans, blas::Transpose::AblasNoTrans,srcPackage.alpha,local_beta);
+    local_gemm(B, A, C, localDimensionN, localDimensionK, gemmArgs);
   }
   if (std::is_same<StructureC,uppertri>::value) { C.swap_pad(); auto counter=0; for (auto i=0; i<localDimensionN; i++) { for (auto j=0; j<(i+1); j++) C.scratch()[counter++] = C.pad()[i*localDimensionN+j]; } }
-  if (std::is_same<StructureC,lowertri>::value) { C.swap_pad(); auto counter=0; for (auto i=0; i<localDimensionN; i++) { for (auto j=0; j<(localDimensionN-i); j++) C.scratch()[counter++] = C.pad()[i*localDimensionN+j]; } }
+  if (std::is_same<StructureC,lowertri>::value) { C.swap_pad(); auto counter=0; for (auto i=0; i<localDimensionN; i++) { for (auto j=i; j<localDimensionN; j++) C.scratch()[counter++] = C.pad()[i*localDimensionN+j]; } }
   collect(C,std::forward<CommType>(CommInfo));
-
-  if (srcPackage.beta != 0.){
-    // Future optimization: Reduce loop length by half since the update will be a symmetric matrix and only half will be used going forward.
-    for (auto i=0; i<C.num_elems(); i++){ C.data()[i] = srcPackage.beta*C.data()[i] + C.scratch()[i]; }
-  } else{ C.swap(); }
+  // Future optimization: Reduce the update loop length by half since the update will be a symmetric matrix and only half will be used going forward.
+  retrieve(C,srcPackage.beta);
   // Reset before returning
-  if (!std::is_same<StructureA,rect>::value) { A.swap_pad(); }
+  if (expands<StructureA>()) { A.swap_pad(); }
   if (isRootRow){ A.swap(); }
+  A._return_(); B._return_(); C._return_();
 #ifdef FUNCTION_SYMBOLS
   CRITTER_STOP(Summa::syrk_int);
 #endif
 }
 
+// Recursion over the local index range [start,end) of A. The half of B that depends only on itself through op(A) is solved first:
+//   the leading half for a left-lower or right-upper solve, the trailing half otherwise.
+template<typename MatrixAType, typename MatrixBType, typename CommType>
+void summa::trsm_internal(MatrixAType& A, MatrixBType& B, int64_t start, int64_t end, CommType&& CommInfo, const blas::ArgPack_trsm<typename MatrixAType::ScalarType>& srcPackage, int64_t bcDimension){
+  using T = typename MatrixAType::ScalarType; using U = typename MatrixAType::DimensionType;
+  using ViewAType = view<T,U,typename MatrixAType::AllocatorType>; using ViewBType = view<T,U,typename MatrixBType::AllocatorType>;
+  if (((end-start)*CommInfo.d <= bcDimension) || ((end-start) < 2)){
+    trsm_base_case(A, B, start, end, std::forward<CommType>(CommInfo), srcPackage); return;
+  }
+  bool left = (srcPackage.side == blas::Side::AblasLeft); bool upper = (srcPackage.uplo == blas::UpLo::AblasUpper);
+  int64_t mid = start + (end-start)/2;
+  int64_t firstStart = (left != upper ? start : mid); int64_t firstEnd = (left != upper ? mid : end);
+  int64_t secondStart = (left != upper ? mid : start); int64_t secondEnd = (left != upper ? end : mid);
+  U localDimensionM = B.num_rows_local(); U localDimensionN = B.num_columns_local();
+
+  trsm_internal(A, B, firstStart, firstEnd, std::forward<CommType>(CommInfo), srcPackage, bcDimension);
+  blas::ArgPack_gemm<T> gemmArgs(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasNoTrans, -1., 1.);
+  if (left){
+    // B2 <- B2 - A21*B1
+    ViewAType A21(A,firstStart,firstEnd,secondStart,secondEnd);
+    ViewBType B1(B,0,localDimensionN,firstStart,firstEnd); ViewBType B2(B,0,localDimensionN,secondStart,secondEnd);
+    invoke(A21, B1, B2, std::forward<CommType>(CommInfo), gemmArgs);
+  }
+  else{
+    // B2 <- B2 - B1*A12
+    ViewAType A12(A,secondStart,secondEnd,firstStart,firstEnd);
+    ViewBType B1(B,firstStart,firstEnd,0,localDimensionM); ViewBType B2(B,secondStart,secondEnd,0,localDimensionM);
+    invoke(B1, A12, B2, std::forward<CommType>(CommInfo), gemmArgs);
+  }
+  trsm_internal(A, B, secondStart, secondEnd, std::forward<CommType>(CommInfo), srcPackage, bcDimension);
+}
+
+// The diagonal block [start,end) of A is gathered over the slice, and the matching rows (left side) or columns (right side) of B over
+//   the processor column (row) that shares them. Each process of the first layer solves the whole panel and keeps its own part, which
+//   is then broadcast along depth to the layers replicating it. Padding past the global order is not solved.
+template<typename MatrixAType, typename MatrixBType, typename CommType>
+void summa::trsm_base_case(MatrixAType& A, MatrixBType& B, int64_t start, int64_t end, CommType&& CommInfo, const blas::ArgPack_trsm<typename MatrixAType::ScalarType>& srcPackage){
+  using T = typename MatrixAType::ScalarType;
+  bool left = (srcPackage.side == blas::Side::AblasLeft);
+  int64_t d = CommInfo.d; int64_t localOrder = end-start; int64_t order = localOrder*d;
+  int64_t span = std::min(order, int64_t(A.num_rows_global())-start*d);
+  int64_t width = (left ? B.num_columns_local() : B.num_rows_local());
+  if (span <= 0 || width == 0) return;
+
+  if (CommInfo.z == 0){
+    // The slice process at (x,y) holds the block's rows y+j*d and columns x+i*d. Slice rank order depends on the layout, so the
+    //   coordinates are gathered with the blocks. block_to_cyclic_rect keeps only the upper triangle, so the blocks are placed here
+    //   for either triangle.
+    int coords[2] = {int(CommInfo.x), int(CommInfo.y)}; std::vector<int> sliceCoords(2*d*d);
+    MPI_Allgather(&coords[0], 2, MPI_INT, &sliceCoords[0], 2, MPI_INT, CommInfo.slice);
+    std::vector<T> localBlock(localOrder*localOrder), blocked(order*order), diag(order*order);
+    for (int64_t i=0; i<localOrder; i++){ std::memcpy(&localBlock[i*localOrder], &A.data()[A.offset_local(start+i,start)], localOrder*sizeof(T)); }
+    MPI_Allgather(&localBlock[0], localOrder*localOrder, mpi_type<T>::type, &blocked[0], localOrder*localOrder, mpi_type<T>::type, CommInfo.slice);
+    for (int64_t p=0; p<d*d; p++){
+      int64_t px = sliceCoords[2*p]; int64_t py = sliceCoords[2*p+1];
+      for (int64_t i=0; i<localOrder; i++){
+        for (int64_t j=0; j<localOrder; j++){ diag[(px+i*d)*order+py+j*d] = blocked[p*localOrder*localOrder+i*localOrder+j]; }
+      }
+    }
+
+    std::vector<T> localPanel(localOrder*width), gathered(order*width), panel(order*width);
+    if (left){
+      for (int64_t i=0; i<width; i++){ std::memcpy(&localPanel[i*localOrder], &B.data()[B.offset_local(i,start)], localOrder*sizeof(T)); }
+      MPI_Allgather(&localPanel[0], localOrder*width, mpi_type<T>::type, &gathered[0], localOrder*width, mpi_type<T>::type, CommInfo.column);
+      for (int64_t p=0; p<d; p++){
+        for (int64_t i=0; i<width; i++){
+          for (int64_t j=0; j<localOrder; j++){ panel[i*order+p+j*d] = gathered[p*localOrder*width+i*localOrder+j]; }
+        }
+      }
+      blas::engine::_trsm(&diag[0], &panel[0], span, width, order, order, srcPackage);
+      for (int64_t i=0; i<width; i++){
+        for (int64_t j=0; j<localOrder; j++){ B.data()[B.offset_local(i,start+j)] = panel[i*order+CommInfo.y+j*d]; }
+      }
+    }
+    else{
+      std::memcpy(&localPanel[0], &B.data()[B.offset_local(start,0)], localOrder*width*sizeof(T));
+      MPI_Allgather(&localPanel[0], localOrder*width, mpi_type<T>::type, &gathered[0], localOrder*width, mpi_type<T>::type, CommInfo.row);
+      for (int64_t p=0; p<d; p++){
+        for (int64_t j=0; j<localOrder; j++){ std::memcpy(&panel[(p+j*d)*width], &gathered[(p*localOrder+j)*width], width*sizeof(T)); }
+      }
+      blas::engine::_trsm(&diag[0], &panel[0], width, span, order, width, srcPackage);
+      for (int64_t j=0; j<localOrder; j++){ std::memcpy(&B.data()[B.offset_local(start+j,0)], &panel[(CommInfo.x+j*d)*width], width*sizeof(T)); }
+    }
+  }
+  if (left){ MPI_Bcast(&B.data()[B.offset_local(0,start)], 1, mpi_subtype<T>::strided(localOrder,width,B.num_rows_local()), 0, CommInfo.depth); }
+  else{ MPI_Bcast(&B.data()[B.offset_local(start,0)], localOrder*width, mpi_type<T>::type, 0, CommInfo.depth); }
+}
+
 template<typename MatrixAType, typename MatrixBType, typename CommType>
 void summa::distribute(MatrixAType& A, MatrixBType& B, CommType&& CommInfo){
 #ifdef FUNCTION_SYMBOLS
@@ -169,81 +307,92 @@ void summa::distribute(MatrixAType& A, MatrixBType& B, CommType&& CommInfo){
   using StructureA = typename MatrixAType::StructureType; using StructureB = typename MatrixBType::StructureType;
 
   auto localDimensionM = A.num_rows_local(); auto localDimensionN = B.num_columns_local();
-  auto localDimensionK = A.num_columns_local(); auto sizeA  = A.num_elems(); auto sizeB  = B.num_elems();
+  auto localDimensionK = A.num_columns_local();
   bool isRootRow = ((CommInfo.x == CommInfo.z) ? true : false);
   bool isRootColumn = ((CommInfo.y == CommInfo.z) ? true : false);
+  T* buffer; int count; MPI_Datatype type;
 
   // Check chunk size. If its 0, then bcast across rows and columns with no overlap
   if (CommInfo.num_chunks == 0){
     // distribute across rows
+    source(A,0,1,isRootRow,buffer,count,type);
 #ifdef COLLECTIVE_CONCURRENCY_SOLO
     if (CommInfo.z==0 && CommInfo.y==0)
 #endif
 #ifdef COLLECTIVE_CONCURRENCY_LAYER
     if (CommInfo.z==CommInfo.y)
 #endif
-    MPI_Bcast(A.scratch(), sizeA, mpi_type<T>::type, CommInfo.z, CommInfo.row);
+    MPI_Bcast(buffer, count, type, CommInfo.z, CommInfo.row);
     // distribute across columns
+    source(B,0,1,isRootColumn,buffer,count,type);
 #ifdef COLLECTIVE_CONCURRENCY_SOLO
     if (CommInfo.z==0 && CommInfo.x==0)
 #endif
 #ifdef COLLECTIVE_CONCURRENCY_LAYER
     if (CommInfo.z==CommInfo.x)
 #endif
-    MPI_Bcast(B.scratch(), sizeB, mpi_type<T>::type, CommInfo.z, CommInfo.column);
+    MPI_Bcast(buffer, count, type, CommInfo.z, CommInfo.column);
   }
   else{
+    // The chunked broadcasts are pipelined against each other only. No local work overlaps them, since the root expansion below and
+    //   every local product that follows read whole operands.
     // initiate distribution across rows
     std::vector<MPI_Request> row_req(CommInfo.num_chunks); std::vector<MPI_Request> column_req(CommInfo.num_chunks);
     std::vector<MPI_Status> row_stat(CommInfo.num_chunks); std::vector<MPI_Status> column_stat(CommInfo.num_chunks);
-    int64_t offset = sizeA%CommInfo.num_chunks; int64_t progress=0;
     for (int64_t idx=0; idx < CommInfo.num_chunks; idx++){
-      MPI_Ibcast(&A.scratch()[progress], idx==(CommInfo.num_chunks-1) ? sizeA/CommInfo.num_chunks+offset : sizeA/CommInfo.num_chunks,
-                 mpi_type<T>::type, CommInfo.z, CommInfo.row, &row_req[idx]);
-      progress += sizeA/CommInfo.num_chunks;
-    }
+      source(A,idx,CommInfo.num_chunks,isRootRow,buffer,count,type);
+      MPI_Ibcast(buffer, count, type, CommInfo.z, CommInfo.row, &row_req[idx]);
+      }
     // initiate distribution along columns and complete distribution across rows
-    offset = sizeB%CommInfo.num_chunks; progress=0;
     for (int64_t idx=0; idx < CommInfo.num_chunks; idx++){
-     MPI_Ibcast(&B.scratch()[progress], idx==(CommInfo.num_chunks-1) ? sizeB/CommInfo.num_chunks+offset : sizeB/CommInfo.num_chunks,
-                mpi_type<T>::type, CommInfo.z, CommInfo.column, &column_req[idx]);
-      progress += sizeB/CommInfo.num_chunks;
-      MPI_Wait(&row_req[idx],&row_stat[idx]);
+      source(B,idx,CommInfo.num_chunks,isRootColumn,buffer,count,type);
+      MPI_Ibcast(buffer, count, type, CommInfo.z, CommInfo.column, &column_req[idx]);
+        MPI_Wait(&row_req[idx],&row_stat[idx]);
     }
     // complete distribution along columns
     for (int64_t idx=0; idx < CommInfo.num_chunks; idx++){ MPI_Wait(&column_req[idx],&column_stat[idx]); }
   }
-  if (!std::is_same<StructureA,rect>::value){ serialize<StructureA,StructureA>::invoke(A,A,0,localDimensionK,0,localDimensionM,0,localDimensionK,0,localDimensionM,1,2); A.swap_pad(); }
-  if (!std::is_same<StructureB,rect>::value){ serialize<StructureB,StructureB>::invoke(B,B,0,localDimensionN,0,localDimensionN,0,localDimensionN,0,localDimensionN,1,2); B.swap_pad(); }
+  // Packed operands were received directly into their pad; only the roots still have to expand their own copy.
+  //   Either way only the stored triangle was written, so clear the other one on every rank.
+  if (expands<StructureA>()){ if (isRootRow){ serialize<StructureA,StructureA>::invoke(A,A,0,localDimensionK,0,localDimensionM,0,localDimensionK,0,localDimensionM,1,2); } clear_complement(A); A.swap_pad(); }
+  if (expands<StructureB>()){ if (isRootColumn){ serialize<StructureB,StructureB>::invoke(B,B,0,localDimensionN,0,localDimensionN,0,localDimensionN,0,localDimensionN,1,2); } clear_complement(B); B.swap_pad(); }
 #ifdef FUNCTION_SYMBOLS
   CRITTER_STOP(Summa::distribute);
 #endif
 }
 
+template<typename MatrixType, typename CommType>
+void summa::attach(MatrixType& matrix, CommType&& CommInfo, size_t slot){
+  // Operands without their own scratch/pad receive broadcasts and reductions in the topology's shared workspace
+  using T = typename MatrixType::ScalarType; using Structure = typename MatrixType::StructureType;
+  matrix._borrow_(workspace::get<T>(CommInfo,2*slot,matrix.num_elems()),
+                  std::is_same<Structure,rect>::value ? nullptr : workspace::get<T>(CommInfo,2*slot+1,matrix.num_rows_local()*matrix.num_columns_local()));
+}
+
 template<typename MatrixType, typename CommType>
 void summa::collect(MatrixType& matrix, CommType&& CommInfo){
 #ifdef FUNCTION_SYMBOLS
   CRITTER_START(Summa::collect);
 #endif
   using T = typename MatrixType::ScalarType;
+  T* buffer; int count; MPI_Datatype type;
   if (CommInfo.num_chunks == 0){
+    chunk(matrix,0,1,buffer,count,type);
 #ifdef COLLECTIVE_CONCURRENCY_SOLO
     if (CommInfo.x==0 && CommInfo.y==0)
 #endif
 #ifdef COLLECTIVE_CONCURRENCY_LAYER
     if (CommInfo.x==CommInfo.y)
 #endif
-    MPI_Allreduce(MPI_IN_PLACE,matrix.scratch(), matrix.num_elems(), mpi_type<T>::type, MPI_SUM, CommInfo.depth);
+    MPI_Allreduce(MPI_IN_PLACE, buffer, count, type, MPI_SUM, CommInfo.depth);
   }
   else{
     // initiate collection along depth
     std::vector<MPI_Request> req(CommInfo.num_chunks); std::vector<MPI_Status> stat(CommInfo.num_chunks);
-    int64_t offset = matrix.num_elems()%CommInfo.num_chunks; int64_t progress=0;
     for (int64_t idx=0; idx < CommInfo.num_chunks; idx++){
-      MPI_Iallreduce(MPI_IN_PLACE, &matrix.scratch()[progress], idx==(CommInfo.num_chunks-1) ? matrix.num_elems()/CommInfo.num_chunks+offset : matrix.num_elems()/CommInfo.num_chunks,
-                     mpi_type<T>::type, MPI_SUM, CommInfo.depth, &req[idx]);
-      progress += matrix.num_elems()/CommInfo.num_chunks;
-    }
+      chunk(matrix,idx,CommInfo.num_chunks,buffer,count,type);
+      MPI_Iallreduce(MPI_IN_PLACE, buffer, count, type, MPI_SUM, CommInfo.depth, &req[idx]);
+      }
     // complete
     for (int64_t idx=0; idx < CommInfo.num_chunks; idx++){ MPI_Wait(&req[idx],&stat[idx]); }
   }
@@ -251,4 +400,173 @@ void summa::collect(MatrixType& matrix, CommType&& CommInfo){
   CRITTER_STOP(Summa::collect);
 #endif
 }
+
+// Local gemm in the column chunks of C, each reduced along depth as soon as it is formed. One mpi_progress thread tests the posted
+//   reductions while the remaining blocks are multiplied, which run on one backend thread fewer so that the thread has a core.
+//   That needs MPI_THREAD_SERIALIZED (the drivers request it); at a lower thread level the multiply keeps every thread, and reductions
+//   advance only in the tests between blocks, or asynchronously where the MPI library progresses them on its own.
+template<typename MatrixAType, typename MatrixBType, typename MatrixCType, typename CommType>
+void summa::gemm_collect(MatrixAType& A, MatrixBType& B, MatrixCType& C, int64_t m, int64_t n, int64_t k, CommType&& CommInfo, const blas::ArgPack_gemm<typename MatrixAType::ScalarType>& srcPackage){
+#ifdef FUNCTION_SYMBOLS
+  CRITTER_START(Summa::gemm_collect);
+#endif
+  using T = typename MatrixAType::ScalarType;
+  T* buffer; int count; MPI_Datatype type;
+  int num_threads = blas::engine::backend::get_num_threads();
+  mpi_progress progress(CommInfo.num_chunks);
+  {
+    blas::thread_budget budget(progress.active() ? std::max(1,num_threads-1) : 0);
+    for (int64_t idx=0; idx < CommInfo.num_chunks; idx++){
+      int64_t first = idx*(n/CommInfo.num_chunks); int64_t last = (idx==(CommInfo.num_chunks-1) ? n : first+n/CommInfo.num_chunks);
+      if (last > first){
+        T* columnsB = B.scratch() + (srcPackage.transposeB == blas::Transpose::AblasNoTrans ? first*leading_dimension(B) : first);
+        blas::engine::_gemm(A.scratch(), columnsB, C.scratch() + first*leading_dimension(C), m, last-first, k,
+                            leading_dimension(A), leading_dimension(B), leading_dimension(C), srcPackage);
+      }
+      chunk(C,idx,CommInfo.num_chunks,buffer,count,type);
+      progress.post([&](MPI_Request* request){ MPI_Iallreduce(MPI_IN_PLACE, buffer, count, type, MPI_SUM, CommInfo.depth, request); });
+    }
+  }
+  progress.wait();
+#ifdef FUNCTION_SYMBOLS
+  CRITTER_STOP(Summa::gemm_collect);
+#endif
+}
+
+template<typename MatrixType>
+int64_t summa::leading_dimension(const MatrixType& matrix){
+  return matrix.num_rows_local();
+}
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+int64_t summa::leading_dimension(const view<ScalarType,DimensionType,AllocatorPolicy>& matrix){
+  return matrix.ld_scratch();
+}
+
+// Chunk idx of num_chunks of a matrix's scratch. Rect matrices are split by column, like views, so that a chunk of an output is
+//   exactly the columns formed by one block of gemm_collect; other structures are split by element.
+template<typename MatrixType>
+void summa::chunk(MatrixType& matrix, int64_t idx, int64_t num_chunks, typename MatrixType::ScalarType*& buffer, int& count, MPI_Datatype& type){
+  if (std::is_same<typename MatrixType::StructureType,rect>::value){
+    int64_t numColumns = matrix.num_columns_local(); int64_t first = idx*(numColumns/num_chunks);
+    int64_t last = (idx==(num_chunks-1) ? numColumns : first+numColumns/num_chunks);
+    buffer = &matrix.scratch()[first*matrix.num_rows_local()]; count = (last-first)*matrix.num_rows_local();
+  }
+  else{
+    int64_t size = matrix.num_elems();
+    buffer = &matrix.scratch()[idx*(size/num_chunks)]; count = (idx==(num_chunks-1) ? size/num_chunks+size%num_chunks : size/num_chunks);
+  }
+  type = mpi_type<typename MatrixType::ScalarType>::type;
+}
+
+// Expansion writes only the stored triangle of the pad. The pad may be a workspace buffer left dirty by an earlier call,
+//   so zero the opposite triangle before the dense local kernels read it.
+template<typename MatrixType>
+void summa::clear_complement(MatrixType& matrix){
+  using Structure = typename MatrixType::StructureType;
+  if (!std::is_same<Structure,uppertri>::value && !std::is_same<Structure,lowertri>::value) return;
+  int64_t numRows = matrix.num_rows_local(); int64_t numColumns = matrix.num_columns_local();
+  for (int64_t i=0; i<numColumns; i++){
+    int64_t first = (std::is_same<Structure,uppertri>::value ? std::min(i+1,numRows) : 0);
+    int64_t last = (std::is_same<Structure,uppertri>::value ? numRows : std::min(i,numRows));
+    std::fill(matrix.pad()+i*numRows+first, matrix.pad()+i*numRows+last, typename MatrixType::ScalarType(0));
+  }
+}
+
+// Chunk idx of num_chunks of a broadcast operand. Packed operands are split by column: the root sends its packed scratch, while every
+//   other rank receives the same elements straight into the expanded layout of its pad through a cached datatype.
+template<typename MatrixType>
+void summa::source(MatrixType& matrix, int64_t idx, int64_t num_chunks, bool isRoot, typename MatrixType::ScalarType*& buffer, int& count, MPI_Datatype& type){
+  using T = typename MatrixType::ScalarType; using Structure = typename MatrixType::StructureType;
+  if (!expands<Structure>()){ chunk(matrix,idx,num_chunks,buffer,count,type); return; }
+  int64_t numColumns = matrix.num_columns_local(); char dir = (std::is_same<Structure,uppertri>::value ? 'U' : 'L');
+  int64_t first = idx*(numColumns/num_chunks); int64_t last = (idx==(num_chunks-1) ? numColumns : first+numColumns/num_chunks);
+  if (isRoot){
+    auto start = [&](int64_t x){ return (x==numColumns ? int64_t(matrix.num_elems()) : int64_t(matrix.offset_local(x,(dir=='U' ? 0 : x),1))); };
+    buffer = &matrix.scratch()[start(first)]; count = start(last)-start(first); type = mpi_type<T>::type;
+  }
+  else{
+    buffer = matrix.pad(); count = 1; type = mpi_subtype<T>::triangle(matrix,first,last,0,matrix.num_rows_local(),2,dir);
+  }
+}
+
+// Chunk idx of num_chunks of a view's scratch, split by column so a strided scratch can be described with one vector type
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void summa::chunk(view<ScalarType,DimensionType,AllocatorPolicy>& matrix, int64_t idx, int64_t num_chunks, ScalarType*& buffer, int& count, MPI_Datatype& type){
+  int64_t numColumns = (idx==(num_chunks-1) ? matrix.num_columns_local()/num_chunks+matrix.num_columns_local()%num_chunks : matrix.num_columns_local()/num_chunks);
+  buffer = &matrix.scratch()[idx*(matrix.num_columns_local()/num_chunks)*matrix.ld_scratch()];
+  if ((matrix.ld_scratch() == matrix.num_rows_local()) || (numColumns == 0)){ count = numColumns*matrix.num_rows_local(); type = mpi_type<ScalarType>::type; }
+  else{ count = 1; type = matrix._column_type_(numColumns); }
+}
+
+// Output operands that are received and reduced directly in their own storage. Reductions require intrinsic datatypes,
+//   so this holds only for views whose columns are contiguous.
+template<typename MatrixType>
+bool summa::alias(MatrixType& matrix){
+  return false;
+}
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+bool summa::alias(view<ScalarType,DimensionType,AllocatorPolicy>& matrix){
+  return matrix._alias_();
+}
+
+// Places a root's in/out operand in scratch for broadcasting
+template<typename MatrixType>
+void summa::stage(MatrixType& matrix){
+  matrix.swap();
+}
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void summa::stage(view<ScalarType,DimensionType,AllocatorPolicy>& matrix){
+  matrix._pack_();
+}
+
+// Moves the reduced output in scratch into data, scaled by beta
+template<typename MatrixType>
+void summa::retrieve(MatrixType& matrix, typename MatrixType::ScalarType beta){
+  if (beta != typename MatrixType::ScalarType(0)){
+    for (auto i=0; i<matrix.num_elems(); i++){ matrix.data()[i] = beta*matrix.data()[i] + matrix.scratch()[i]; }
+  }
+  else{ matrix.swap(); }
+}
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void summa::retrieve(view<ScalarType,DimensionType,AllocatorPolicy>& matrix, ScalarType beta){
+  if (matrix.scratch() != matrix.data()){ matrix._unpack_(beta); }
+}
+
+// Local trmm on the broadcast operands
+template<typename MatrixAType, typename MatrixBType>
+void summa::local_trmm(MatrixAType& A, MatrixBType& B, int64_t m, int64_t n, const blas::ArgPack_trmm<typename MatrixAType::ScalarType>& srcPackage){
+  blas::engine::_trmm(A.scratch(), B.scratch(), m, n, leading_dimension(A), leading_dimension(B), srcPackage);
+}
+
+template<typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy, typename MatrixBType>
+void summa::local_trmm(matrix<ScalarType,DimensionType,rfp,OffloadPolicy,AllocatorPolicy>& A, MatrixBType& B, int64_t m, int64_t n, const blas::ArgPack_trmm<ScalarType>& srcPackage){
+  blas::engine::_trmm_rfp(A.scratch(), B.scratch(), m, n, leading_dimension(B), srcPackage);
+}
+
+// Local gemm forming the square output of a syrk; an rfp output receives only its upper triangle
+template<typename MatrixAType, typename MatrixBType, typename MatrixCType>
+void summa::local_gemm(MatrixAType& A, MatrixBType& B, MatrixCType& C, int64_t n, int64_t k, const blas::ArgPack_gemm<typename MatrixAType::ScalarType>& srcPackage){
+  blas::engine::_gemm(A.scratch(), B.scratch(), C.scratch(), n, n, k, leading_dimension(A), leading_dimension(B), leading_dimension(C), srcPackage);
+}
+
+template<typename MatrixAType, typename MatrixBType, typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy>
+void summa::local_gemm(MatrixAType& A, MatrixBType& B, matrix<ScalarType,DimensionType,rfp,OffloadPolicy,AllocatorPolicy>& C, int64_t n, int64_t k, const blas::ArgPack_gemm<ScalarType>& srcPackage){
+  blas::engine::_gemm_rfp(A.scratch(), B.scratch(), C.scratch(), C.pad(), n, k, leading_dimension(A), leading_dimension(B), srcPackage);
+}
+
+template<typename MatrixAType, typename MatrixBType, typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy>
+void summa::local_gemm(MatrixAType& A, MatrixBType& B, matrix<ScalarType,DimensionType,uppertri,OffloadPolicy,AllocatorPolicy>& C, int64_t n, int64_t k, const blas::ArgPack_gemm<ScalarType>& srcPackage){
+  blas::ArgPack_gemmt<ScalarType> gemmtPack(srcPackage.order, blas::UpLo::AblasUpper, srcPackage.transposeA, srcPackage.transposeB, srcPackage.alpha, srcPackage.beta);
+  blas::engine::_gemmt(A.scratch(), B.scratch(), C.scratch(), n, k, leading_dimension(A), leading_dimension(B), leading_dimension(C), gemmtPack);
+}
+
+template<typename MatrixAType, typename MatrixBType, typename ScalarType, typename DimensionType, typename OffloadPolicy, typename AllocatorPolicy>
+void summa::local_gemm(MatrixAType& A, MatrixBType& B, matrix<ScalarType,DimensionType,lowertri,OffloadPolicy,AllocatorPolicy>& C, int64_t n, int64_t k, const blas::ArgPack_gemm<ScalarType>& srcPackage){
+  blas::ArgPack_gemmt<ScalarType> gemmtPack(srcPackage.order, blas::UpLo::AblasLower, srcPackage.transposeA, srcPackage.transposeB, srcPackage.alpha, srcPackage.beta);
+  blas::engine::_gemmt(A.scratch(), B.scratch(), C.scratch(), n, k, leading_dimension(A), leading_dimension(B), leading_dimension(C), gemmtPack);
+}
 }
@@ -0,0 +1,29 @@
+/* Author: Edward Hutter */
+
+#ifndef MATMULT__WORKSPACE_H_
+#define MATMULT__WORKSPACE_H_
+
+namespace matmult{
+
+// Communication buffers shared by every summa invocation on the same grid shape.
+//   Each operand position (slot) owns one buffer per grid shape (c,d), grown to the largest request seen, so working memory
+//   follows the largest summa in flight rather than the number of live intermediate matrices. Keying on the shape rather than
+//   the communicator lets topologies rebuilt on every factorization reuse the same buffers.
+class workspace{
+public:
+  template<typename ScalarType, typename CommType>
+  static ScalarType* get(CommType&& CommInfo, size_t slot, size_t num_elems);
+
+  template<typename CommType>
+  static void release(CommType&& CommInfo);
+
+  static size_t num_bytes();
+
+private:
+  static std::map<std::tuple<int64_t,int64_t,size_t>,std::vector<char>>& table();
+};
+}
+
+#include "workspace.hpp"
+
+#endif /* MATMULT__WORKSPACE_H_ */
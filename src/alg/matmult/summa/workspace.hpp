@@ -0,0 +1,31 @@
+/* Author: Edward Hutter */
+
+namespace matmult{
+
+template<typename ScalarType, typename CommType>
+ScalarType* workspace::get(CommType&& CommInfo, size_t slot, size_t num_elems){
+  auto& buffer = table()[std::make_tuple(int64_t(CommInfo.c),int64_t(CommInfo.d),slot)];
+  if (buffer.size() < num_elems*sizeof(ScalarType)){ buffer.resize(num_elems*sizeof(ScalarType)); }
+  return (ScalarType*)&buffer[0];
+}
+
+template<typename CommType>
+void workspace::release(CommType&& CommInfo){
+  auto& t = table();
+  for (auto it = t.begin(); it != t.end();){
+    if ((std::get<0>(it->first) == CommInfo.c) && (std::get<1>(it->first) == CommInfo.d)){ it = t.erase(it); }
+    else { it++; }
+  }
+}
+
+inline size_t workspace::num_bytes(){
+  size_t count=0;
+  for (auto& it : table()){ count += it.second.size(); }
+  return count;
+}
+
+inline std::map<std::tuple<int64_t,int64_t,size_t>,std::vector<char>>& workspace::table(){
+  static std::map<std::tuple<int64_t,int64_t,size_t>,std::vector<char>> t;
+  return t;
+}
+}
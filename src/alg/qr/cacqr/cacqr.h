@@ -34,9 +34,7 @@ public:
     matrix<ScalarType,DimensionType,rect> Q;
     matrix<ScalarType,DimensionType,typename SerializePolicy::structure> R;
     // Optimizing members
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,typename SerializePolicy::structure>> policy_table;
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect>> rect_table1;
-    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect>> rect_table2;
+    std::map<std::pair<DimensionType,DimensionType>,matrix<ScalarType,DimensionType,rect,OffloadEachGemm,typename IntermediatesPolicy::allocator>> rect_table1;
   };
 
   template<typename MatrixType, typename ArgType, typename CommType>
@@ -72,9 +70,6 @@ protected:
 
   template<typename ArgType, typename CommType>
   static void solve(ArgType& args, CommType&& CommInfo);
-
-  template<typename ArgType, typename CommType>
-  static void simulate_solve(ArgType& args, CommType&& CommInfo);
 };
 }
 
@@ -28,45 +28,16 @@ void cacqr<SerializePolicy,IntermediatesPolicy>::sweep_1d(ArgType& args, CommTyp
 #endif
 }
 
-template<class SerializePolicy, class IntermediatesPolicy>
-template<typename ArgType, typename CommType>
-void cacqr<SerializePolicy,IntermediatesPolicy>::simulate_solve(ArgType& args, CommType&& CommInfo){
-  using SP = SerializePolicy; using IP = IntermediatesPolicy;
-  auto localDimensionN = args.R.num_rows_local(); auto localDimensionM = args.Q.num_rows_local();
-  auto split1 = (localDimensionN>>args.cholesky_inverse_args.split); auto split2 = localDimensionN-split1;
-  IP::init(args.rect_table1,std::make_pair(split1,localDimensionM),nullptr,split1,localDimensionM,CommInfo.c,CommInfo.c);
-  IP::init(args.rect_table2,std::make_pair(split2,localDimensionM),nullptr,split2,localDimensionM,CommInfo.c,CommInfo.c);
-  IP::init(args.rect_table2,std::make_pair(split2,split1),nullptr,split2,split1,CommInfo.c,CommInfo.c);
-  IP::init(args.policy_table,std::make_pair(split1,split1),nullptr,split1,split1,CommInfo.c,CommInfo.c);
-  IP::init(args.policy_table,std::make_pair(split2,split2),nullptr,split2,split2,CommInfo.c,CommInfo.c);
-}
-
 template<class SerializePolicy, class IntermediatesPolicy>
 template<typename ArgType, typename CommType>
 void cacqr<SerializePolicy,IntermediatesPolicy>::solve(ArgType& args, CommType&& CommInfo){
 #ifdef FUNCTION_SYMBOLS
   CRITTER_START(CQR::solve);
 #endif
-  using T = typename ArgType::ScalarType; using SP = SerializePolicy; using IP = IntermediatesPolicy;
-  auto localDimensionN = args.R.num_rows_local(); auto localDimensionM = args.Q.num_rows_local();
-  auto split1 = (localDimensionN>>args.cholesky_inverse_args.split); auto split2 = localDimensionN-split1;
-  serialize<rect,rect>::invoke(args.Q,IP::invoke(args.rect_table1,std::make_pair(split1,localDimensionM)),0,split1,0,localDimensionM,0,split1,0,localDimensionM);
-  serialize<rect,rect>::invoke(args.Q,IP::invoke(args.rect_table2,std::make_pair(split2,localDimensionM)),split1,localDimensionN,0,localDimensionM,0,split2,0,localDimensionM);
-  serialize<uppertri,uppertri>::invoke(args.cholesky_inverse_args.Rinv,IP::invoke(args.policy_table,std::make_pair(split1,split1)),0,split1,0,split1,0,split1,0,split1);
-  serialize<rect,rect>::invoke(args.cholesky_inverse_args.R,IP::invoke(args.rect_table2,std::make_pair(split2,split1)),split1,localDimensionN,0,split1,0,split2,0,split1);
-  blas::ArgPack_gemm<T> gemmPack(blas::Order::AblasColumnMajor, blas::Transpose::AblasNoTrans, blas::Transpose::AblasNoTrans, 1., -1.);
-  blas::ArgPack_trmm<T> trmmPack(blas::Order::AblasColumnMajor, blas::Side::AblasRight, blas::UpLo::AblasUpper, blas::Transpose::AblasNoTrans, blas::Diag::AblasNonUnit, 1.);
-  matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split1,split1)),IP::invoke(args.rect_table1,std::make_pair(split1,localDimensionM)),
-                         std::forward<CommType>(CommInfo), trmmPack);
-  serialize<uppertri,uppertri>::invoke(args.cholesky_inverse_args.Rinv,IP::invoke(args.policy_table,std::make_pair(split2,split2)),split1,localDimensionN,split1,localDimensionN,0,split2,0,split2);
-  matmult::summa::invoke(IP::invoke(args.rect_table1,std::make_pair(split1,localDimensionM)),IP::invoke(args.rect_table2,std::make_pair(split2,split1)),
-                         IP::invoke(args.rect_table2,std::make_pair(split2,localDimensionM)), std::forward<CommType>(CommInfo), gemmPack);
-  matmult::summa::invoke(IP::invoke(args.policy_table,std::make_pair(split2,split2)),IP::invoke(args.rect_table2,std::make_pair(split2,localDimensionM)),
-                         std::forward<CommType>(CommInfo), trmmPack);
-  serialize<rect,rect>::invoke(IP::invoke(args.rect_table1,std::make_pair(split1,localDimensionM)),args.Q,0,split1,0,localDimensionM,0,split1,0,localDimensionM);
-  serialize<rect,rect>::invoke(IP::invoke(args.rect_table2,std::make_pair(split2,localDimensionM)),args.Q,0,split2,0,localDimensionM,split1,localDimensionN,0,localDimensionM);
-  IP::flush(args.rect_table1[std::make_pair(split1,localDimensionM)]); IP::flush(args.rect_table2[std::make_pair(split2,localDimensionM)]);
-  IP::flush(args.policy_table[std::make_pair(split1,split1)]); IP::flush(args.policy_table[std::make_pair(split2,split2)]);
+  using T = typename ArgType::ScalarType;
+  // Q <- Q*R^{-1} by a distributed triangular solve with R, so no block of R^{-1} is used
+  blas::ArgPack_trsm<T> trsmPack(blas::Order::AblasColumnMajor, blas::Side::AblasRight, blas::UpLo::AblasUpper, blas::Transpose::AblasNoTrans, blas::Diag::AblasNonUnit, 1.);
+  matmult::summa::invoke(args.cholesky_inverse_args.R, args.Q, std::forward<CommType>(CommInfo), trsmPack);
 #ifdef FUNCTION_SYMBOLS
   CRITTER_STOP(CQR::solve);
 #endif
@@ -228,7 +199,6 @@ void cacqr<SerializePolicy,IntermediatesPolicy>::factor(const MatrixType& A, Arg
   IP::init(args.rect_table1,std::make_pair(globalDimensionN,globalDimensionN),globalDimensionN,globalDimensionN,CommInfo.c,CommInfo.c);
   if (CommInfo.c == 1){ invoke_1d(args, std::forward<CommType>(CommInfo)); }
   else{
-    if (!args.cholesky_inverse_args.complete_inv) simulate_solve(args,std::forward<CommType>(CommInfo));
     if (CommInfo.c == CommInfo.d){ invoke_3d(args, topo::square(CommInfo.cube,CommInfo.c,CommInfo.layout,CommInfo.num_chunks)); }
     else{
       auto SquareTopo = topo::square(CommInfo.cube,CommInfo.c,CommInfo.layout,CommInfo.num_chunks);
@@ -244,6 +214,7 @@ void cacqr<SerializePolicy,IntermediatesPolicy>::factor(const MatrixType& A, Arg
     }
   }
   IP::flush(args.rect_table1[std::make_pair(globalDimensionN,globalDimensionN)]);
+  serialize_plan::clear();
   CRITTER_STOP(CQR::factor);
 }
 
@@ -139,6 +139,10 @@ protected:
 // ***********************************************************************************************************************************************************************
 class SaveIntermediates{
 protected:
+  // Saved buffers live as long as the args that own them; pooling them lets the next factorization of the same shape reuse them
+  //   (PoolAllocator::release returns them to the system)
+  using allocator = PoolAllocator;
+
   template<typename TableType, typename KeyType, typename... ValueTypes>
   static void init(TableType& table, KeyType&& key, ValueTypes&&... values){
     if (table.find(key) == table.end()){
@@ -157,6 +161,9 @@ protected:
 
 class FlushIntermediates{
 protected:
+  // Flushed buffers go straight back to the system, so the peak footprint stays that of the current recursion level
+  using allocator = StandardAllocator;
+
   template<typename TableType, typename KeyType, typename... ValueTypes>
   static void init(TableType& table, KeyType&& key, ValueTypes&&... values){
     if (table.find(key) == table.end()){
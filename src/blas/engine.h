@@ -48,7 +48,9 @@ enum class Diag : unsigned char{
 enum class Method : unsigned char{
   AblasGemm = 0x0,
   AblasTrmm = 0x1,
-  AblasSyrk = 0x10
+  AblasTrsm = 0x2,
+  AblasSyrk = 0x10,
+  AblasGemmt = 0x11
 };
 
 // Empty Base class for generic BLAS method arguments -- this is to prevent another template overload that is unnecessary
@@ -110,6 +112,29 @@ public:
   T alpha;					// Added this constant
 };
 
+// B <- alpha*op(A)^{-1}*B (left side) or B <- alpha*B*op(A)^{-1} (right side)
+template<typename T>
+class ArgPack_trsm : public ArgPack<T>{
+public:
+  ArgPack_trsm(Order orderArg, Side sideArg, UpLo uploArg, Transpose transposeAArg,
+    Diag diagArg, T alphaArg){
+    this->method = Method::AblasTrsm;
+    this->order = orderArg;
+    this->side = sideArg;
+    this->uplo = uploArg;
+    this->transposeA = transposeAArg;
+    this->diag = diagArg;
+    this->alpha = alphaArg;
+  }
+
+  Order order;
+  Side side;
+  UpLo uplo;
+  Transpose transposeA;
+  Diag diag;
+  T alpha;
+};
+
 template<typename T>
 class ArgPack_syrk : public ArgPack<T>{
 public:
@@ -128,6 +153,28 @@ public:
   T alpha;					// Added this constant
   T beta;					// Added this constant
 };
+
+// gemm that forms only the uplo triangle of the square output
+template<typename T>
+class ArgPack_gemmt : public ArgPack<T>{
+public:
+  ArgPack_gemmt(Order orderArg, UpLo uploArg, Transpose transposeAArg, Transpose transposeBArg, T alphaArg, T betaArg){
+    this->method = Method::AblasGemmt;
+    this->order = orderArg;
+    this->uplo = uploArg;
+    this->transposeA = transposeAArg;
+    this->transposeB = transposeBArg;
+    this->alpha = alphaArg;
+    this->beta = betaArg;
+  }
+
+  Order order;
+  UpLo uplo;
+  Transpose transposeA;
+  Transpose transposeB;
+  T alpha;
+  T beta;
+};
 }
 
 // Local includes -- include the possible BLAS libraries
@@ -5,6 +5,7 @@
 
 // Local includes
 #include "./../util/shared.h"
+#include "./../util/microkernel.h"
 
 // Goal: Have a BLAS Policy with the particular BLAS implementation as one of the Policy classes
 //       This will allow for easier switching when needing alternate BLAS implementations
@@ -36,8 +37,37 @@ protected:
   template<typename T>
   static void setInfoParameters_trmm(const ArgPack_trmm<T>& srcPackage, CBLAS_ORDER& destArg1, CBLAS_SIDE& destArg2, CBLAS_UPLO& destArg3, CBLAS_TRANSPOSE& destArg4, CBLAS_DIAG& destArg5);
 
+  template<typename T>
+  static void setInfoParameters_trsm(const ArgPack_trsm<T>& srcPackage, CBLAS_ORDER& destArg1, CBLAS_SIDE& destArg2, CBLAS_UPLO& destArg3, CBLAS_TRANSPOSE& destArg4, CBLAS_DIAG& destArg5);
+
   template<typename T>
   static void setInfoParameters_syrk(const ArgPack_syrk<T>& srcPackage, CBLAS_ORDER& destArg1, CBLAS_UPLO& destArg2, CBLAS_TRANSPOSE& destArg3);
+
+  template<typename T>
+  static void setInfoParameters_gemmt(const ArgPack_gemmt<T>& srcPackage, CBLAS_ORDER& destArg1, CBLAS_UPLO& destArg2, CBLAS_TRANSPOSE& destArg3, CBLAS_TRANSPOSE& destArg4);
+
+  // The factorizations here are Hermitian, so for complex types AblasTrans is the conjugate transpose
+  template<typename T>
+  static CBLAS_TRANSPOSE transpose_arg(Transpose trans);
+
+  // Whether a real-valued call is small enough and of a variant covered by the fixed-size kernels (see microkernel)
+  template<typename T>
+  static bool use_microkernel(const ArgPack_trmm<T>& srcPackage, int64_t m, int64_t n);
+
+#ifdef BACKEND_GEMM_BATCH
+  // Per-group arguments of cblas_?gemm_batch. Consecutive entries that agree in every argument but their matrices share a group, so
+  //   MKL dispatches them together. All entries must share one order.
+  template<typename T>
+  class gemm_batch_args{
+  public:
+    gemm_batch_args(const int64_t* m, const int64_t* n, const int64_t* k, const int64_t* lda, const int64_t* ldb, const int64_t* ldc,
+                    const ArgPack_gemm<T>* srcPackage, int64_t count);
+    CBLAS_ORDER layout;
+    std::vector<CBLAS_TRANSPOSE> transA,transB;
+    std::vector<MKL_INT> m,n,k,lda,ldb,ldc,group_size;
+    std::vector<T> alpha,beta;
+  };
+#endif
 };
 
 
@@ -54,6 +84,9 @@ public:
   engine& operator=(engine&& rhs) = delete;
   ~engine() = delete;
 
+  // Backend Policy selected in config.mk
+  using backend = ::backend::active;
+
   // Engine methods
   template<typename T>
   static void _gemm(T* matrixA, T* matrixB, T* matrixC, int64_t m, int64_t n, int64_t k,
@@ -62,8 +95,76 @@ public:
   template<typename T>
   static void _trmm(T* matrixA, T* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trmm<T>& srcPackage);
 
+  template<typename T>
+  static void _trsm(T* matrixA, T* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trsm<T>& srcPackage);
+
+  // herk for complex types
   template<typename T>
   static void _syrk(T* matrixA, T* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldc, const ArgPack_syrk<T>& srcPackage);
+
+  // The uplo triangle of C <- alpha*op(A)*op(B) + beta*C of order n; the opposite triangle is not referenced.
+  //   Backends without gemmt (see backend.h) split the triangle recursively into full gemm blocks.
+  template<typename T>
+  static void _gemmt(T* matrixA, T* matrixB, T* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<T>& srcPackage);
+
+  // Independent small multiplies dispatched in one call: entry i is _gemm (_trmm) on the i'th operands, dimensions and argument pack.
+  //   Entries may run concurrently, so no two entries may write overlapping memory. gemm batches go to cblas_?gemm_batch where the
+  //   backend has it (BACKEND_GEMM_BATCH); otherwise, and for trmm, entries go through _dispatch_batch.
+  template<typename T>
+  static void _gemm_batch(T* const* matrixA, T* const* matrixB, T* const* matrixC, const int64_t* m, const int64_t* n, const int64_t* k,
+                          const int64_t* lda, const int64_t* ldb, const int64_t* ldc, const ArgPack_gemm<T>* srcPackage, int64_t count);
+
+  template<typename T>
+  static void _trmm_batch(T* const* matrixA, T* const* matrixB, const int64_t* m, const int64_t* n, const int64_t* lda, const int64_t* ldb,
+                          const ArgPack_trmm<T>* srcPackage, int64_t count);
+
+  // Calls entry(i) for i in [0,count) over OpenMP threads, each entry on one backend thread so that concurrent entries do not oversubscribe the cores
+  template<typename EntryType>
+  static void _dispatch_batch(int64_t count, EntryType&& entry);
+
+  // matrixA is upper-triangular of order (Left side ? m : n) in Rectangular Full Packed format (see rfp). Composed of two trmm and one gemm.
+  template<typename T>
+  static void _trmm_rfp(T* matrixA, T* matrixB, int64_t m, int64_t n, int64_t ldb, const ArgPack_trmm<T>& srcPackage);
+
+  // Upper triangle of C <- alpha*op(A)*op(B) + beta*C of order n, with C in Rectangular Full Packed format.
+  //   The two diagonal blocks are formed side by side in work, which must hold (n/2)^2+(n-n/2)^2 elements.
+  template<typename T>
+  static void _gemm_rfp(T* matrixA, T* matrixB, T* matrixC, T* work, int64_t n, int64_t k, int64_t lda, int64_t ldb, const ArgPack_gemm<T>& srcPackage);
+
+private:
+  template<typename T>
+  static void _gemmt_blocked(T* matrixA, T* matrixB, T* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<T>& srcPackage);
+};
+
+// ************************************************************************************************************************************************************
+// Thread budget for the engine calls made while an instance is in scope, e.g. to leave a core free to progress nonblocking
+//   communication during a local multiply. The previous count is restored on destruction, so also when the scope is left by an
+//   exception. Under OpenBLAS and BLIS the count is process-wide rather than thread-local (see backend::local_threads), so a
+//   budget there applies to every thread while it is in scope. A budget of 0 threads leaves the count unchanged.
+class thread_budget{
+public:
+  explicit thread_budget(int num_threads) : _active(num_threads>0), _previous(_active ? engine::backend::set_num_threads_local(num_threads) : 0) {}
+  ~thread_budget(){ if (this->_active) engine::backend::set_num_threads_local(this->_previous); }
+  thread_budget(const thread_budget& rhs) = delete;
+  thread_budget& operator=(const thread_budget& rhs) = delete;
+private:
+  bool _active;
+  int _previous;
+};
+
+// ************************************************************************************************************************************************************
+// Sibling products queued by a schedule and dispatched together by flush. Queued products must be independent of each other.
+template<typename T>
+class batch{
+public:
+  void gemm(T* matrixA, T* matrixB, T* matrixC, int64_t m, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemm<T>& srcPackage);
+  void trmm(T* matrixA, T* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trmm<T>& srcPackage);
+  void flush();
+private:
+  std::vector<T*> gemm_A,gemm_B,gemm_C,trmm_A,trmm_B;
+  std::vector<int64_t> gemm_dims,trmm_dims;// m,n,k,lda,ldb,ldc per gemm, and m,n,lda,ldb per trmm
+  std::vector<ArgPack_gemm<T>> gemm_packs;
+  std::vector<ArgPack_trmm<T>> trmm_packs;
 };
 }
 
@@ -10,8 +10,8 @@ void helper::setInfoParameters_gemm(const ArgPack_gemm<T>& srcPackage,
   // Lots of branches :( --> I can use tertiary operator ?, which is much cheaper than an if/else statements
 
   destArg1 = (srcPackage.order == Order::AblasRowMajor ? CblasRowMajor : CblasColMajor);
-  destArg2 = (srcPackage.transposeA == Transpose::AblasTrans ? CblasTrans : CblasNoTrans);
-  destArg3 = (srcPackage.transposeB == Transpose::AblasTrans ? CblasTrans : CblasNoTrans);
+  destArg2 = transpose_arg<T>(srcPackage.transposeA);
+  destArg3 = transpose_arg<T>(srcPackage.transposeB);
 }
 
 template<typename T>
@@ -25,7 +25,22 @@ void helper::setInfoParameters_trmm(const ArgPack_trmm<T>& srcPackage,
   destArg1 = (srcPackage.order == Order::AblasRowMajor ? CblasRowMajor : CblasColMajor);
   destArg2 = (srcPackage.side == Side::AblasLeft ? CblasLeft : CblasRight);
   destArg3 = (srcPackage.uplo == UpLo::AblasLower ? CblasLower : CblasUpper);
-  destArg4 = (srcPackage.transposeA == Transpose::AblasTrans ? CblasTrans : CblasNoTrans);
+  destArg4 = transpose_arg<T>(srcPackage.transposeA);
+  destArg5 = (srcPackage.diag == Diag::AblasUnit ? CblasUnit : CblasNonUnit);
+}
+
+template<typename T>
+void helper::setInfoParameters_trsm(const ArgPack_trsm<T>& srcPackage,
+                                    CBLAS_ORDER& destArg1,
+                                    CBLAS_SIDE& destArg2,
+                                    CBLAS_UPLO& destArg3,
+                                    CBLAS_TRANSPOSE& destArg4,
+                                    CBLAS_DIAG& destArg5
+                                   ){
+  destArg1 = (srcPackage.order == Order::AblasRowMajor ? CblasRowMajor : CblasColMajor);
+  destArg2 = (srcPackage.side == Side::AblasLeft ? CblasLeft : CblasRight);
+  destArg3 = (srcPackage.uplo == UpLo::AblasLower ? CblasLower : CblasUpper);
+  destArg4 = transpose_arg<T>(srcPackage.transposeA);
   destArg5 = (srcPackage.diag == Diag::AblasUnit ? CblasUnit : CblasNonUnit);
 }
 
@@ -37,7 +52,33 @@ void helper::setInfoParameters_syrk(const ArgPack_syrk<T>& srcPackage,
                                    ){
   destArg1 = (srcPackage.order == Order::AblasRowMajor ? CblasRowMajor : CblasColMajor);
   destArg2 = (srcPackage.uplo == UpLo::AblasLower ? CblasLower : CblasUpper);
-  destArg3 = (srcPackage.transposeA == Transpose::AblasTrans ? CblasTrans : CblasNoTrans);
+  destArg3 = transpose_arg<T>(srcPackage.transposeA);
+}
+
+template<typename T>
+void helper::setInfoParameters_gemmt(const ArgPack_gemmt<T>& srcPackage,
+                                     CBLAS_ORDER& destArg1,
+                                     CBLAS_UPLO& destArg2,
+                                     CBLAS_TRANSPOSE& destArg3,
+                                     CBLAS_TRANSPOSE& destArg4
+                                    ){
+  destArg1 = (srcPackage.order == Order::AblasRowMajor ? CblasRowMajor : CblasColMajor);
+  destArg2 = (srcPackage.uplo == UpLo::AblasLower ? CblasLower : CblasUpper);
+  destArg3 = transpose_arg<T>(srcPackage.transposeA);
+  destArg4 = transpose_arg<T>(srcPackage.transposeB);
+}
+
+template<typename T>
+CBLAS_TRANSPOSE helper::transpose_arg(Transpose trans){
+  return (trans == Transpose::AblasTrans ? (is_complex<T>::value ? CblasConjTrans : CblasTrans) : CblasNoTrans);
+}
+
+// Right-side products are covered only without transposition
+template<typename T>
+bool helper::use_microkernel(const ArgPack_trmm<T>& srcPackage, int64_t m, int64_t n){
+  bool left = (srcPackage.side == Side::AblasLeft);
+  return (srcPackage.order == Order::AblasColumnMajor) && (srcPackage.uplo == UpLo::AblasUpper) && (srcPackage.diag == Diag::AblasNonUnit)
+         && (left || (srcPackage.transposeA == Transpose::AblasNoTrans)) && ((left ? m : n) <= microkernel::order_threshold());
 }
 
 template<>
@@ -71,13 +112,38 @@ void engine::_trmm(double* matrixA, double* matrixB, int64_t m, int64_t n, int64
 #ifdef FUNCTION_SYMBOLS
 CRITTER_START(trmm);
 #endif
-  cblas_dtrmm(arg1, arg2, arg3, arg4, arg5, m, n, srcPackage.alpha, matrixA,
-    lda, matrixB, ldb);
+  if (use_microkernel(srcPackage, m, n)){
+    microkernel::trmm(matrixA, matrixB, m, n, lda, ldb, srcPackage.side == Side::AblasLeft, srcPackage.transposeA == Transpose::AblasTrans, srcPackage.alpha);
+  }
+  else{
+    cblas_dtrmm(arg1, arg2, arg3, arg4, arg5, m, n, srcPackage.alpha, matrixA,
+      lda, matrixB, ldb);
+  }
 #ifdef FUNCTION_SYMBOLS
 CRITTER_STOP(trmm);
 #endif
 }
 
+template<>
+void engine::_trsm(double* matrixA, double* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trsm<double>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trsm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trsm);
+#endif
+  cblas_dtrsm(arg1, arg2, arg3, arg4, arg5, m, n, srcPackage.alpha, matrixA,
+    lda, matrixB, ldb);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trsm);
+#endif
+}
+
 template<>
 void engine::_syrk(double* matrixA, double* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldc, const ArgPack_syrk<double>& srcPackage){
   // First, unpack the info parameter
@@ -95,4 +161,564 @@ CRITTER_START(syrk);
 CRITTER_STOP(syrk);
 #endif
 }
+
+template<>
+void engine::_gemm(float* matrixA, float* matrixB, float* matrixC, int64_t m, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemm<float>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_TRANSPOSE arg2;
+  CBLAS_TRANSPOSE arg3;
+  setInfoParameters_gemm(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm);
+#endif
+  cblas_sgemm(arg1, arg2, arg3, m, n, k, srcPackage.alpha,
+    matrixA, lda, matrixB, ldb, srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm);
+#endif
+}
+
+template<>
+void engine::_trmm(float* matrixA, float* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trmm<float>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trmm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trmm);
+#endif
+  if (use_microkernel(srcPackage, m, n)){
+    microkernel::trmm(matrixA, matrixB, m, n, lda, ldb, srcPackage.side == Side::AblasLeft, srcPackage.transposeA == Transpose::AblasTrans, srcPackage.alpha);
+  }
+  else{
+    cblas_strmm(arg1, arg2, arg3, arg4, arg5, m, n, srcPackage.alpha, matrixA,
+      lda, matrixB, ldb);
+  }
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trmm);
+#endif
+}
+
+template<>
+void engine::_trsm(float* matrixA, float* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trsm<float>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trsm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trsm);
+#endif
+  cblas_strsm(arg1, arg2, arg3, arg4, arg5, m, n, srcPackage.alpha, matrixA,
+    lda, matrixB, ldb);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trsm);
+#endif
+}
+
+template<>
+void engine::_syrk(float* matrixA, float* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldc, const ArgPack_syrk<float>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  setInfoParameters_syrk(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(syrk);
+#endif
+  cblas_ssyrk(arg1, arg2, arg3, n, k, srcPackage.alpha, matrixA,
+    lda, srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(syrk);
+#endif
+}
+
+template<>
+void engine::_gemm(std::complex<float>* matrixA, std::complex<float>* matrixB, std::complex<float>* matrixC, int64_t m, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemm<std::complex<float>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_TRANSPOSE arg2;
+  CBLAS_TRANSPOSE arg3;
+  setInfoParameters_gemm(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm);
+#endif
+  cblas_cgemm(arg1, arg2, arg3, m, n, k, &srcPackage.alpha,
+    matrixA, lda, matrixB, ldb, &srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm);
+#endif
+}
+
+template<>
+void engine::_trmm(std::complex<float>* matrixA, std::complex<float>* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trmm<std::complex<float>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trmm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trmm);
+#endif
+  cblas_ctrmm(arg1, arg2, arg3, arg4, arg5, m, n, &srcPackage.alpha, matrixA,
+    lda, matrixB, ldb);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trmm);
+#endif
+}
+
+template<>
+void engine::_trsm(std::complex<float>* matrixA, std::complex<float>* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trsm<std::complex<float>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trsm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trsm);
+#endif
+  cblas_ctrsm(arg1, arg2, arg3, arg4, arg5, m, n, &srcPackage.alpha, matrixA,
+    lda, matrixB, ldb);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trsm);
+#endif
+}
+
+template<>
+void engine::_syrk(std::complex<float>* matrixA, std::complex<float>* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldc, const ArgPack_syrk<std::complex<float>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  setInfoParameters_syrk(srcPackage, arg1, arg2, arg3);
+  // The Hermitian rank-k update: alpha and beta are real and C <- alpha*A^H*A + beta*C
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(syrk);
+#endif
+  cblas_cherk(arg1, arg2, arg3, n, k, std::real(srcPackage.alpha), matrixA,
+    lda, std::real(srcPackage.beta), matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(syrk);
+#endif
+}
+
+template<>
+void engine::_gemm(std::complex<double>* matrixA, std::complex<double>* matrixB, std::complex<double>* matrixC, int64_t m, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemm<std::complex<double>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_TRANSPOSE arg2;
+  CBLAS_TRANSPOSE arg3;
+  setInfoParameters_gemm(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm);
+#endif
+  cblas_zgemm(arg1, arg2, arg3, m, n, k, &srcPackage.alpha,
+    matrixA, lda, matrixB, ldb, &srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm);
+#endif
+}
+
+template<>
+void engine::_trmm(std::complex<double>* matrixA, std::complex<double>* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trmm<std::complex<double>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trmm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trmm);
+#endif
+  cblas_ztrmm(arg1, arg2, arg3, arg4, arg5, m, n, &srcPackage.alpha, matrixA,
+    lda, matrixB, ldb);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trmm);
+#endif
+}
+
+template<>
+void engine::_trsm(std::complex<double>* matrixA, std::complex<double>* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trsm<std::complex<double>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_SIDE arg2;
+  CBLAS_UPLO arg3;
+  CBLAS_TRANSPOSE arg4;
+  CBLAS_DIAG arg5;
+  setInfoParameters_trsm(srcPackage, arg1, arg2, arg3, arg4, arg5);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trsm);
+#endif
+  cblas_ztrsm(arg1, arg2, arg3, arg4, arg5, m, n, &srcPackage.alpha, matrixA,
+    lda, matrixB, ldb);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trsm);
+#endif
+}
+
+template<>
+void engine::_syrk(std::complex<double>* matrixA, std::complex<double>* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldc, const ArgPack_syrk<std::complex<double>>& srcPackage){
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  setInfoParameters_syrk(srcPackage, arg1, arg2, arg3);
+  // The Hermitian rank-k update: alpha and beta are real and C <- alpha*A^H*A + beta*C
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(syrk);
+#endif
+  cblas_zherk(arg1, arg2, arg3, n, k, std::real(srcPackage.alpha), matrixA,
+    lda, std::real(srcPackage.beta), matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(syrk);
+#endif
+}
+
+template<>
+void engine::_gemmt(double* matrixA, double* matrixB, double* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<double>& srcPackage){
+#ifdef BACKEND_GEMMT
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  CBLAS_TRANSPOSE arg4;
+  setInfoParameters_gemmt(srcPackage, arg1, arg2, arg3, arg4);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemmt);
+#endif
+  cblas_dgemmt(arg1, arg2, arg3, arg4, n, k, srcPackage.alpha, matrixA,
+    lda, matrixB, ldb, srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemmt);
+#endif
+#else
+  _gemmt_blocked(matrixA, matrixB, matrixC, n, k, lda, ldb, ldc, srcPackage);
+#endif
+}
+
+template<>
+void engine::_gemmt(float* matrixA, float* matrixB, float* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<float>& srcPackage){
+#ifdef BACKEND_GEMMT
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  CBLAS_TRANSPOSE arg4;
+  setInfoParameters_gemmt(srcPackage, arg1, arg2, arg3, arg4);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemmt);
+#endif
+  cblas_sgemmt(arg1, arg2, arg3, arg4, n, k, srcPackage.alpha, matrixA,
+    lda, matrixB, ldb, srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemmt);
+#endif
+#else
+  _gemmt_blocked(matrixA, matrixB, matrixC, n, k, lda, ldb, ldc, srcPackage);
+#endif
+}
+
+template<>
+void engine::_gemmt(std::complex<float>* matrixA, std::complex<float>* matrixB, std::complex<float>* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<std::complex<float>>& srcPackage){
+#ifdef BACKEND_GEMMT
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  CBLAS_TRANSPOSE arg4;
+  setInfoParameters_gemmt(srcPackage, arg1, arg2, arg3, arg4);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemmt);
+#endif
+  cblas_cgemmt(arg1, arg2, arg3, arg4, n, k, &srcPackage.alpha, matrixA,
+    lda, matrixB, ldb, &srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemmt);
+#endif
+#else
+  _gemmt_blocked(matrixA, matrixB, matrixC, n, k, lda, ldb, ldc, srcPackage);
+#endif
+}
+
+template<>
+void engine::_gemmt(std::complex<double>* matrixA, std::complex<double>* matrixB, std::complex<double>* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<std::complex<double>>& srcPackage){
+#ifdef BACKEND_GEMMT
+  // First, unpack the info parameter
+  CBLAS_ORDER arg1;
+  CBLAS_UPLO arg2;
+  CBLAS_TRANSPOSE arg3;
+  CBLAS_TRANSPOSE arg4;
+  setInfoParameters_gemmt(srcPackage, arg1, arg2, arg3, arg4);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemmt);
+#endif
+  cblas_zgemmt(arg1, arg2, arg3, arg4, n, k, &srcPackage.alpha, matrixA,
+    lda, matrixB, ldb, &srcPackage.beta, matrixC, ldc);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemmt);
+#endif
+#else
+  _gemmt_blocked(matrixA, matrixB, matrixC, n, k, lda, ldb, ldc, srcPackage);
+#endif
+}
+
+// The triangle is halved until its order fits a small diagonal block: the off-diagonal quarter is one full gemm, and a diagonal block
+//   is formed whole in a local buffer so that only its triangle is written back to C.
+template<typename T>
+void engine::_gemmt_blocked(T* matrixA, T* matrixB, T* matrixC, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemmt<T>& srcPackage){
+  // A row-major problem is the column-major problem for C^T = op(B)^T*op(A)^T, whose stored triangle is the opposite one
+  if (srcPackage.order == Order::AblasRowMajor){
+    ArgPack_gemmt<T> colPackage(Order::AblasColumnMajor, (srcPackage.uplo == UpLo::AblasUpper ? UpLo::AblasLower : UpLo::AblasUpper),
+                                srcPackage.transposeB, srcPackage.transposeA, srcPackage.alpha, srcPackage.beta);
+    _gemmt_blocked(matrixB, matrixA, matrixC, n, k, ldb, lda, ldc, colPackage);
+    return;
+  }
+  constexpr int64_t block = 32;
+  // Row i of op(A) and column j of op(B)
+  auto rowA = [&](int64_t i){ return srcPackage.transposeA == Transpose::AblasNoTrans ? matrixA+i : matrixA+i*lda; };
+  auto colB = [&](int64_t j){ return srcPackage.transposeB == Transpose::AblasNoTrans ? matrixB+j*ldb : matrixB+j; };
+  ArgPack_gemm<T> gemmPack(Order::AblasColumnMajor, srcPackage.transposeA, srcPackage.transposeB, srcPackage.alpha, srcPackage.beta);
+  bool upper = (srcPackage.uplo == UpLo::AblasUpper);
+  if (n <= block){
+    T work[block*block];
+    gemmPack.beta = 0;
+    _gemm(rowA(0), colB(0), work, n, n, k, lda, ldb, n, gemmPack);
+    for (int64_t j=0; j<n; j++){
+      for (int64_t i=(upper ? 0 : j); i<(upper ? j+1 : n); i++){
+        matrixC[j*ldc+i] = (srcPackage.beta == T(0) ? work[j*n+i] : srcPackage.beta*matrixC[j*ldc+i] + work[j*n+i]);
+      }
+    }
+    return;
+  }
+  int64_t n1 = n/2; int64_t n2 = n-n1;
+  _gemmt_blocked(rowA(0), colB(0), matrixC, n1, k, lda, ldb, ldc, srcPackage);
+  if (upper){ _gemm(rowA(0), colB(n1), matrixC+n1*ldc, n1, n2, k, lda, ldb, ldc, gemmPack); }
+  else{ _gemm(rowA(n1), colB(0), matrixC+n1, n2, n1, k, lda, ldb, ldc, gemmPack); }
+  _gemmt_blocked(rowA(n1), colB(n1), matrixC+n1*ldc+n1, n2, k, lda, ldb, ldc, srcPackage);
+}
+
+#ifdef BACKEND_GEMM_BATCH
+template<typename T>
+helper::gemm_batch_args<T>::gemm_batch_args(const int64_t* m, const int64_t* n, const int64_t* k, const int64_t* lda, const int64_t* ldb, const int64_t* ldc,
+                                            const ArgPack_gemm<T>* srcPackage, int64_t count){
+  for (int64_t i=0; i<count; i++){
+    assert(srcPackage[i].order == srcPackage[0].order);
+    CBLAS_TRANSPOSE tA, tB; setInfoParameters_gemm(srcPackage[i], this->layout, tA, tB);
+    // An entry joins the previous group when it matches in every argument but the matrices
+    if ((i>0) && (tA == this->transA.back()) && (tB == this->transB.back()) && (m[i] == this->m.back()) && (n[i] == this->n.back()) &&
+        (k[i] == this->k.back()) && (lda[i] == this->lda.back()) && (ldb[i] == this->ldb.back()) && (ldc[i] == this->ldc.back()) &&
+        (srcPackage[i].alpha == this->alpha.back()) && (srcPackage[i].beta == this->beta.back())){
+      this->group_size.back()++; continue;
+    }
+    this->transA.push_back(tA); this->transB.push_back(tB);
+    this->m.push_back(m[i]); this->n.push_back(n[i]); this->k.push_back(k[i]);
+    this->lda.push_back(lda[i]); this->ldb.push_back(ldb[i]); this->ldc.push_back(ldc[i]);
+    this->alpha.push_back(srcPackage[i].alpha); this->beta.push_back(srcPackage[i].beta); this->group_size.push_back(1);
+  }
+}
+
+template<>
+void engine::_gemm_batch(double* const* matrixA, double* const* matrixB, double* const* matrixC, const int64_t* m, const int64_t* n, const int64_t* k,
+                         const int64_t* lda, const int64_t* ldb, const int64_t* ldc, const ArgPack_gemm<double>* srcPackage, int64_t count){
+  gemm_batch_args<double> args(m, n, k, lda, ldb, ldc, srcPackage, count);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm_batch);
+#endif
+  cblas_dgemm_batch(args.layout, &args.transA[0], &args.transB[0], &args.m[0], &args.n[0], &args.k[0], &args.alpha[0],
+    (const double**)matrixA, &args.lda[0], (const double**)matrixB, &args.ldb[0], &args.beta[0], (double**)matrixC, &args.ldc[0], args.group_size.size(), &args.group_size[0]);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm_batch);
+#endif
+}
+
+template<>
+void engine::_gemm_batch(float* const* matrixA, float* const* matrixB, float* const* matrixC, const int64_t* m, const int64_t* n, const int64_t* k,
+                         const int64_t* lda, const int64_t* ldb, const int64_t* ldc, const ArgPack_gemm<float>* srcPackage, int64_t count){
+  gemm_batch_args<float> args(m, n, k, lda, ldb, ldc, srcPackage, count);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm_batch);
+#endif
+  cblas_sgemm_batch(args.layout, &args.transA[0], &args.transB[0], &args.m[0], &args.n[0], &args.k[0], &args.alpha[0],
+    (const float**)matrixA, &args.lda[0], (const float**)matrixB, &args.ldb[0], &args.beta[0], (float**)matrixC, &args.ldc[0], args.group_size.size(), &args.group_size[0]);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm_batch);
+#endif
+}
+
+template<>
+void engine::_gemm_batch(std::complex<float>* const* matrixA, std::complex<float>* const* matrixB, std::complex<float>* const* matrixC, const int64_t* m, const int64_t* n, const int64_t* k,
+                         const int64_t* lda, const int64_t* ldb, const int64_t* ldc, const ArgPack_gemm<std::complex<float>>* srcPackage, int64_t count){
+  gemm_batch_args<std::complex<float>> args(m, n, k, lda, ldb, ldc, srcPackage, count);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm_batch);
+#endif
+  cblas_cgemm_batch(args.layout, &args.transA[0], &args.transB[0], &args.m[0], &args.n[0], &args.k[0], &args.alpha[0],
+    (const void**)matrixA, &args.lda[0], (const void**)matrixB, &args.ldb[0], &args.beta[0], (void**)matrixC, &args.ldc[0], args.group_size.size(), &args.group_size[0]);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm_batch);
+#endif
+}
+
+template<>
+void engine::_gemm_batch(std::complex<double>* const* matrixA, std::complex<double>* const* matrixB, std::complex<double>* const* matrixC, const int64_t* m, const int64_t* n, const int64_t* k,
+                         const int64_t* lda, const int64_t* ldb, const int64_t* ldc, const ArgPack_gemm<std::complex<double>>* srcPackage, int64_t count){
+  gemm_batch_args<std::complex<double>> args(m, n, k, lda, ldb, ldc, srcPackage, count);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(gemm_batch);
+#endif
+  cblas_zgemm_batch(args.layout, &args.transA[0], &args.transB[0], &args.m[0], &args.n[0], &args.k[0], &args.alpha[0],
+    (const void**)matrixA, &args.lda[0], (const void**)matrixB, &args.ldb[0], &args.beta[0], (void**)matrixC, &args.ldc[0], args.group_size.size(), &args.group_size[0]);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(gemm_batch);
+#endif
+}
+#else
+template<typename T>
+void engine::_gemm_batch(T* const* matrixA, T* const* matrixB, T* const* matrixC, const int64_t* m, const int64_t* n, const int64_t* k,
+                         const int64_t* lda, const int64_t* ldb, const int64_t* ldc, const ArgPack_gemm<T>* srcPackage, int64_t count){
+  _dispatch_batch(count, [&](int64_t i){ _gemm(matrixA[i], matrixB[i], matrixC[i], m[i], n[i], k[i], lda[i], ldb[i], ldc[i], srcPackage[i]); });
+}
+#endif
+
+template<typename T>
+void engine::_trmm_batch(T* const* matrixA, T* const* matrixB, const int64_t* m, const int64_t* n, const int64_t* lda, const int64_t* ldb,
+                         const ArgPack_trmm<T>* srcPackage, int64_t count){
+  _dispatch_batch(count, [&](int64_t i){ _trmm(matrixA[i], matrixB[i], m[i], n[i], lda[i], ldb[i], srcPackage[i]); });
+}
+
+template<typename EntryType>
+void engine::_dispatch_batch(int64_t count, EntryType&& entry){
+  if (count == 1){ entry(0); return; }
+  // A thread-local count (MKL) is set by every OpenMP thread; a process-wide count is set once, outside the parallel region
+  thread_budget budget(backend::local_threads ? 0 : 1);
+  #pragma omp parallel
+  {
+    thread_budget local(backend::local_threads ? 1 : 0);
+    #pragma omp for schedule(dynamic,1)
+    for (int64_t i=0; i<count; i++){ entry(i); }
+  }
+}
+
+template<typename T>
+void engine::_trmm_rfp(T* matrixA, T* matrixB, int64_t m, int64_t n, int64_t ldb, const ArgPack_trmm<T>& srcPackage){
+  // A = [T1 S; 0 T2] with T1 of order n1 stored transposed (lower) at row n1+1, S at row 0, and T2 of order n2 at row n1
+  static_assert(!is_complex<T>::value, "rfp stores T1 transposed but not conjugated, which complex trmm cannot apply");
+  assert(srcPackage.uplo == UpLo::AblasUpper);
+  int64_t order = (srcPackage.side == Side::AblasLeft ? m : n);
+  int64_t n1 = order>>1; int64_t n2 = order-n1; int64_t ld = ((order&1) ? order : order+1);
+  T* T1 = matrixA+n1+1; T* S = matrixA; T* T2 = matrixA+n1;
+  bool left = (srcPackage.side == Side::AblasLeft); bool trans = (srcPackage.transposeA == Transpose::AblasTrans);
+  // B1 holds the first n1 rows (left) or columns (right) of B
+  T* B1 = matrixB; T* B2 = (left ? matrixB+n1 : matrixB+n1*ldb);
+  int64_t m1 = (left ? n1 : m); int64_t m2 = (left ? n2 : m); int64_t c1 = (left ? n : n1); int64_t c2 = (left ? n : n2);
+  Transpose flip = (trans ? Transpose::AblasNoTrans : Transpose::AblasTrans);
+  ArgPack_trmm<T> pack1(srcPackage.order, srcPackage.side, UpLo::AblasLower, flip, srcPackage.diag, srcPackage.alpha);
+  ArgPack_trmm<T> pack2(srcPackage.order, srcPackage.side, UpLo::AblasUpper, srcPackage.transposeA, srcPackage.diag, srcPackage.alpha);
+  // The block of B that S reads from must be consumed before its own triangle overwrites it
+  if (left != trans){
+    if (n1>0){
+      _trmm(T1, B1, m1, c1, ld, ldb, pack1);
+      ArgPack_gemm<T> gemmPack(srcPackage.order, Transpose::AblasNoTrans, (left ? Transpose::AblasNoTrans : Transpose::AblasTrans), srcPackage.alpha, 1.);
+      if (left) _gemm(S, B2, B1, n1, n, n2, ld, ldb, ldb, gemmPack);
+      else _gemm(B2, S, B1, m, n1, n2, ldb, ld, ldb, gemmPack);
+    }
+    _trmm(T2, B2, m2, c2, ld, ldb, pack2);
+  }
+  else{
+    _trmm(T2, B2, m2, c2, ld, ldb, pack2);
+    if (n1>0){
+      ArgPack_gemm<T> gemmPack(srcPackage.order, (left ? Transpose::AblasTrans : Transpose::AblasNoTrans), Transpose::AblasNoTrans, srcPackage.alpha, 1.);
+      if (left) _gemm(S, B1, B2, n2, n, n1, ld, ldb, ldb, gemmPack);
+      else _gemm(B1, S, B2, m, n2, n1, ldb, ld, ldb, gemmPack);
+      _trmm(T1, B1, m1, c1, ld, ldb, pack1);
+    }
+  }
+}
+
+template<typename T>
+void engine::_gemm_rfp(T* matrixA, T* matrixB, T* matrixC, T* work, int64_t n, int64_t k, int64_t lda, int64_t ldb, const ArgPack_gemm<T>& srcPackage){
+  static_assert(!is_complex<T>::value, "rfp stores T1 transposed but not conjugated");
+  int64_t n1 = n>>1; int64_t n2 = n-n1; int64_t ld = ((n&1) ? n : n+1);
+  // Rows (columns) [n1,n) of op(A) (op(B))
+  T* A2 = (srcPackage.transposeA == Transpose::AblasNoTrans ? matrixA+n1 : matrixA+n1*lda);
+  T* B2 = (srcPackage.transposeB == Transpose::AblasNoTrans ? matrixB+n1*ldb : matrixB+n1);
+  ArgPack_gemm<T> blockPack(srcPackage.order, srcPackage.transposeA, srcPackage.transposeB, srcPackage.alpha, 0.);
+  // The off-diagonal rectangle is formed in place and the two diagonal blocks in work. The three products are independent.
+  T* work1 = work+n2*n2;
+  batch<T> products;
+  if (n1>0){ products.gemm(matrixA, B2, matrixC, n1, n2, k, lda, ldb, ld, srcPackage); }
+  products.gemm(A2, B2, work, n2, n2, k, lda, ldb, n2, blockPack);
+  if (n1>0){ products.gemm(matrixA, matrixB, work1, n1, n1, k, lda, ldb, n1, blockPack); }
+  products.flush();
+  // As in gemm, C is not read when beta is zero
+  for (int64_t j=0; j<n2; j++){
+    for (int64_t i=0; i<=j; i++){ matrixC[j*ld+n1+i] = (srcPackage.beta == T(0) ? work[j*n2+i] : srcPackage.beta*matrixC[j*ld+n1+i] + work[j*n2+i]); }
+  }
+  for (int64_t j=0; j<n1; j++){
+    for (int64_t i=0; i<=j; i++){ matrixC[i*ld+n1+1+j] = (srcPackage.beta == T(0) ? work1[j*n1+i] : srcPackage.beta*matrixC[i*ld+n1+1+j] + work1[j*n1+i]); }
+  }
+}
+
+template<typename T>
+void batch<T>::gemm(T* matrixA, T* matrixB, T* matrixC, int64_t m, int64_t n, int64_t k, int64_t lda, int64_t ldb, int64_t ldc, const ArgPack_gemm<T>& srcPackage){
+  gemm_A.push_back(matrixA); gemm_B.push_back(matrixB); gemm_C.push_back(matrixC);
+  gemm_dims.insert(gemm_dims.end(),{m,n,k,lda,ldb,ldc}); gemm_packs.push_back(srcPackage);
+}
+
+template<typename T>
+void batch<T>::trmm(T* matrixA, T* matrixB, int64_t m, int64_t n, int64_t lda, int64_t ldb, const ArgPack_trmm<T>& srcPackage){
+  trmm_A.push_back(matrixA); trmm_B.push_back(matrixB);
+  trmm_dims.insert(trmm_dims.end(),{m,n,lda,ldb}); trmm_packs.push_back(srcPackage);
+}
+
+template<typename T>
+void batch<T>::flush(){
+  int64_t num_gemm = gemm_A.size(); int64_t num_trmm = trmm_A.size();
+  if ((num_gemm>0) && (num_trmm==0)){
+    // Split the interleaved dimensions into the per-argument arrays the engine takes
+    std::vector<int64_t> dims(num_gemm*6); int64_t* g = dims.data();
+    for (int64_t i=0; i<num_gemm; i++){ for (int64_t j=0; j<6; j++){ g[j*num_gemm+i] = gemm_dims[i*6+j]; } }
+    engine::_gemm_batch(&gemm_A[0], &gemm_B[0], &gemm_C[0], g, g+num_gemm, g+2*num_gemm, g+3*num_gemm, g+4*num_gemm, g+5*num_gemm, &gemm_packs[0], num_gemm);
+  }
+  else if (num_gemm+num_trmm>0){
+    // trmm is not batched by any backend, so mixed products share one dispatch
+    engine::_dispatch_batch(num_gemm+num_trmm, [&](int64_t i){
+      if (i<num_gemm){ const int64_t* d = &gemm_dims[i*6]; engine::_gemm(gemm_A[i], gemm_B[i], gemm_C[i], d[0], d[1], d[2], d[3], d[4], d[5], gemm_packs[i]); }
+      else{ int64_t j = i-num_gemm; const int64_t* d = &trmm_dims[j*4]; engine::_trmm(trmm_A[j], trmm_B[j], d[0], d[1], d[2], d[3], trmm_packs[j]); }
+    });
+  }
+  gemm_A.clear(); gemm_B.clear(); gemm_C.clear(); gemm_dims.clear(); gemm_packs.clear();
+  trmm_A.clear(); trmm_B.clear(); trmm_dims.clear(); trmm_packs.clear();
+}
 }
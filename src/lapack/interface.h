@@ -5,6 +5,7 @@
 
 // Local includes
 #include "./../util/shared.h"
+#include "./../util/microkernel.h"
 
 namespace lapack{
 
@@ -27,6 +28,9 @@ protected:
   static void setInfoParameters_trtri(const ArgPack_trtri& srcPackage, int& destArg1, char& destArg2, char& destArg3);
   static void setInfoParameters_geqrf(const ArgPack_geqrf& srcPackage, int& destArg1);
   static void setInfoParameters_orgqr(const ArgPack_orgqr& srcPackage, int& destArg1);
+  // Whether a real-valued call is small enough and of a variant covered by the fixed-size kernels (see microkernel)
+  static bool use_microkernel(const ArgPack_potrf& srcPackage, int n);
+  static bool use_microkernel(const ArgPack_trtri& srcPackage, int n);
 };
 
 
@@ -45,6 +49,9 @@ public:
   engine& operator=(engine&& rhs) = delete;
   ~engine() = delete;
 
+  // Backend Policy selected in config.mk
+  using backend = ::backend::active;
+
   // Engine methods
   template<typename T>
   static void _potrf(T* matrixA, int n, int lda, const ArgPack_potrf& srcPackage);
@@ -55,6 +62,7 @@ public:
   template<typename T>
   static void _geqrf(T* matrixA, T* tau, int m, int n, int lda, const ArgPack_geqrf& srcPackage);
 
+  // ungqr for complex types
   template<typename T>
   static void _orgqr(T* matrixA, T* tau, int m, int n, int k, int lda, const ArgPack_orgqr& srcPackage);
 };
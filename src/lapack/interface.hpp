@@ -27,6 +27,15 @@ void helper::setInfoParameters_orgqr(const ArgPack_orgqr& srcPackage,
   destArg1 = (srcPackage.order == Order::AlapackRowMajor ? LAPACK_ROW_MAJOR : LAPACK_COL_MAJOR);
 }
 
+bool helper::use_microkernel(const ArgPack_potrf& srcPackage, int n){
+  return (srcPackage.order == Order::AlapackColumnMajor) && (srcPackage.uplo == UpLo::AlapackUpper) && (n <= microkernel::order_threshold());
+}
+
+bool helper::use_microkernel(const ArgPack_trtri& srcPackage, int n){
+  return (srcPackage.order == Order::AlapackColumnMajor) && (srcPackage.uplo == UpLo::AlapackUpper) && (srcPackage.diag == Diag::AlapackNonUnit)
+         && (n <= microkernel::order_threshold());
+}
+
 template<>
 void engine::_potrf(double* matrixA, int n, int lda, const ArgPack_potrf& srcPackage){
   // First, unpack the info parameter
@@ -36,7 +45,8 @@ void engine::_potrf(double* matrixA, int n, int lda, const ArgPack_potrf& srcPac
 #ifdef FUNCTION_SYMBOLS
 CRITTER_START(potrf);
 #endif
-  LAPACKE_dpotrf(arg1, arg2, n, matrixA, lda);
+  if (helper::use_microkernel(srcPackage, n)) microkernel::potrf(matrixA, n, lda);
+  else LAPACKE_dpotrf(arg1, arg2, n, matrixA, lda);
 #ifdef FUNCTION_SYMBOLS
 CRITTER_STOP(potrf);
 #endif
@@ -51,7 +61,8 @@ void engine::_trtri(double* matrixA, int n, int lda, const ArgPack_trtri& srcPac
 #ifdef FUNCTION_SYMBOLS
 CRITTER_START(trtri);
 #endif
-  LAPACKE_dtrtri(arg1, arg2, arg3, n, matrixA, lda);
+  if (helper::use_microkernel(srcPackage, n)) microkernel::trtri(matrixA, n, lda);
+  else LAPACKE_dtrtri(arg1, arg2, arg3, n, matrixA, lda);
 #ifdef FUNCTION_SYMBOLS
 CRITTER_STOP(trtri);
 #endif
@@ -86,4 +97,186 @@ CRITTER_START(orgqr);
 CRITTER_STOP(orgqr);
 #endif
 }
+
+template<>
+void engine::_potrf(float* matrixA, int n, int lda, const ArgPack_potrf& srcPackage){
+  // First, unpack the info parameter
+  int arg1; char arg2;
+  helper::setInfoParameters_potrf(srcPackage, arg1, arg2);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(potrf);
+#endif
+  if (helper::use_microkernel(srcPackage, n)) microkernel::potrf(matrixA, n, lda);
+  else LAPACKE_spotrf(arg1, arg2, n, matrixA, lda);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(potrf);
+#endif
+}
+
+template<>
+void engine::_trtri(float* matrixA, int n, int lda, const ArgPack_trtri& srcPackage){
+  // First, unpack the info parameter
+  int arg1; char arg2; char arg3;
+  helper::setInfoParameters_trtri(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trtri);
+#endif
+  if (helper::use_microkernel(srcPackage, n)) microkernel::trtri(matrixA, n, lda);
+  else LAPACKE_strtri(arg1, arg2, arg3, n, matrixA, lda);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trtri);
+#endif
+}
+
+template<>
+void engine::_geqrf(float* matrixA, float* tau, int m, int n, int lda, const ArgPack_geqrf& srcPackage){
+  // First, unpack the info parameter
+  int arg1;
+  helper::setInfoParameters_geqrf(srcPackage, arg1);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(geqrf);
+#endif
+  LAPACKE_sgeqrf(arg1, m, n, matrixA, lda, tau);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(geqrf);
+#endif
+}
+
+template<>
+void engine::_orgqr(float* matrixA, float* tau, int m, int n, int k, int lda, const ArgPack_orgqr& srcPackage){
+  // First, unpack the info parameter
+  int arg1;
+  helper::setInfoParameters_orgqr(srcPackage, arg1);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(orgqr);
+#endif
+  LAPACKE_sorgqr(arg1, m, n, k, matrixA, lda, tau);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(orgqr);
+#endif
+}
+
+template<>
+void engine::_potrf(std::complex<float>* matrixA, int n, int lda, const ArgPack_potrf& srcPackage){
+  // First, unpack the info parameter
+  int arg1; char arg2;
+  helper::setInfoParameters_potrf(srcPackage, arg1, arg2);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(potrf);
+#endif
+  LAPACKE_cpotrf(arg1, arg2, n, reinterpret_cast<lapack_complex_float*>(matrixA), lda);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(potrf);
+#endif
+}
+
+template<>
+void engine::_trtri(std::complex<float>* matrixA, int n, int lda, const ArgPack_trtri& srcPackage){
+  // First, unpack the info parameter
+  int arg1; char arg2; char arg3;
+  helper::setInfoParameters_trtri(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trtri);
+#endif
+  LAPACKE_ctrtri(arg1, arg2, arg3, n, reinterpret_cast<lapack_complex_float*>(matrixA), lda);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trtri);
+#endif
+}
+
+template<>
+void engine::_geqrf(std::complex<float>* matrixA, std::complex<float>* tau, int m, int n, int lda, const ArgPack_geqrf& srcPackage){
+  // First, unpack the info parameter
+  int arg1;
+  helper::setInfoParameters_geqrf(srcPackage, arg1);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(geqrf);
+#endif
+  LAPACKE_cgeqrf(arg1, m, n, reinterpret_cast<lapack_complex_float*>(matrixA), lda, reinterpret_cast<lapack_complex_float*>(tau));
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(geqrf);
+#endif
+}
+
+template<>
+void engine::_orgqr(std::complex<float>* matrixA, std::complex<float>* tau, int m, int n, int k, int lda, const ArgPack_orgqr& srcPackage){
+  // First, unpack the info parameter
+  int arg1;
+  helper::setInfoParameters_orgqr(srcPackage, arg1);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(orgqr);
+#endif
+  LAPACKE_cungqr(arg1, m, n, k, reinterpret_cast<lapack_complex_float*>(matrixA), lda, reinterpret_cast<lapack_complex_float*>(tau));
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(orgqr);
+#endif
+}
+
+template<>
+void engine::_potrf(std::complex<double>* matrixA, int n, int lda, const ArgPack_potrf& srcPackage){
+  // First, unpack the info parameter
+  int arg1; char arg2;
+  helper::setInfoParameters_potrf(srcPackage, arg1, arg2);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(potrf);
+#endif
+  LAPACKE_zpotrf(arg1, arg2, n, reinterpret_cast<lapack_complex_double*>(matrixA), lda);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(potrf);
+#endif
+}
+
+template<>
+void engine::_trtri(std::complex<double>* matrixA, int n, int lda, const ArgPack_trtri& srcPackage){
+  // First, unpack the info parameter
+  int arg1; char arg2; char arg3;
+  helper::setInfoParameters_trtri(srcPackage, arg1, arg2, arg3);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(trtri);
+#endif
+  LAPACKE_ztrtri(arg1, arg2, arg3, n, reinterpret_cast<lapack_complex_double*>(matrixA), lda);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(trtri);
+#endif
+}
+
+template<>
+void engine::_geqrf(std::complex<double>* matrixA, std::complex<double>* tau, int m, int n, int lda, const ArgPack_geqrf& srcPackage){
+  // First, unpack the info parameter
+  int arg1;
+  helper::setInfoParameters_geqrf(srcPackage, arg1);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(geqrf);
+#endif
+  LAPACKE_zgeqrf(arg1, m, n, reinterpret_cast<lapack_complex_double*>(matrixA), lda, reinterpret_cast<lapack_complex_double*>(tau));
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(geqrf);
+#endif
+}
+
+template<>
+void engine::_orgqr(std::complex<double>* matrixA, std::complex<double>* tau, int m, int n, int k, int lda, const ArgPack_orgqr& srcPackage){
+  // First, unpack the info parameter
+  int arg1;
+  helper::setInfoParameters_orgqr(srcPackage, arg1);
+
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(orgqr);
+#endif
+  LAPACKE_zungqr(arg1, m, n, k, reinterpret_cast<lapack_complex_double*>(matrixA), lda, reinterpret_cast<lapack_complex_double*>(tau));
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(orgqr);
+#endif
+}
 }
@@ -0,0 +1,85 @@
+/* Author: Edward Hutter */
+
+#ifndef MATRIX_ALLOCATOR_H_
+#define MATRIX_ALLOCATOR_H_
+
+// These class policies implement the Allocator Policy used by the Structure Policy to obtain the data, scratch, and pad buffers
+
+// Per-process allocation counters, shared by each allocator policy
+struct allocator_stats{
+  size_t num_requests;		// buffers requested by matrix instances
+  size_t num_allocs;		// buffers obtained from the system
+  size_t bytes_requested;
+  size_t bytes_allocated;
+};
+
+class StandardAllocator{
+public:
+  template<typename ScalarType, typename DimensionType>
+  static ScalarType* _allocate(DimensionType numElems);
+  template<typename ScalarType>
+  static void _deallocate(ScalarType* ptr);
+  static allocator_stats& stats();
+  static void reset_stats();
+  static void _prefetch(const void* ptr, size_t bytes){}
+};
+
+// Cache-line aligned buffers. Buffers spanning at least one huge page are aligned to it and advised with MADV_HUGEPAGE,
+//   so that large local blocks fault in (and are TLB-mapped) 2MB at a time.
+class HugePageAllocator{
+public:
+  template<typename ScalarType, typename DimensionType>
+  static ScalarType* _allocate(DimensionType numElems);
+  template<typename ScalarType>
+  static void _deallocate(ScalarType* ptr);
+  static allocator_stats& stats();
+  static void reset_stats();
+  static void _prefetch(const void* ptr, size_t bytes){}
+private:
+  static constexpr size_t cache_line_size = 64;
+  static constexpr size_t huge_page_size = 1<<21;
+};
+
+// Size-class arena: released buffers are cached on a per-process free list and handed back out to later requests of the same class
+//   Each buffer carries a one-cache-line header that records its size class, so buffers can be released regardless of which
+//   of data/scratch/pad they were last swapped into.
+class PoolAllocator{
+public:
+  template<typename ScalarType, typename DimensionType>
+  static ScalarType* _allocate(DimensionType numElems);
+  template<typename ScalarType>
+  static void _deallocate(ScalarType* ptr);
+  static allocator_stats& stats();
+  static void reset_stats();
+  static void _prefetch(const void* ptr, size_t bytes){}
+  static void release();	// returns all cached buffers to the system
+private:
+  static constexpr size_t header_size = 64;
+  static constexpr size_t num_classes = 256;
+  static size_t get_class(size_t bytes, size_t& class_bytes);
+  static std::vector<void*>& free_list(size_t size_class);
+};
+
+// Out-of-core buffers: each buffer is a shared mapping of its own (immediately unlinked) file in $CAPITAL_MMAP_DIR, so that under
+//   memory pressure the kernel writes pages back to the file rather than to swap. The directory must be disk-backed: the default,
+//   /var/tmp, usually is, whereas /tmp is often tmpfs, which would keep the data in memory. Buffers smaller than min_mapped_size
+//   come from the heap. Failures throw std::bad_alloc (heap) or std::system_error (file and mapping). _prefetch issues
+//   MADV_WILLNEED for ranges that serialize is about to touch.
+class MappedAllocator{
+public:
+  template<typename ScalarType, typename DimensionType>
+  static ScalarType* _allocate(DimensionType numElems);
+  template<typename ScalarType>
+  static void _deallocate(ScalarType* ptr);
+  static allocator_stats& stats();
+  static void reset_stats();
+  static void _prefetch(const void* ptr, size_t bytes);
+private:
+  static constexpr size_t header_size = 64;
+  static constexpr size_t min_mapped_size = 1<<21;
+  static std::string& directory();
+};
+
+#include "allocator.hpp"
+
+#endif /* MATRIX_ALLOCATOR_H_ */
@@ -0,0 +1,169 @@
+/* Author: Edward Hutter */
+
+template<typename ScalarType, typename DimensionType>
+ScalarType* StandardAllocator::_allocate(DimensionType numElems){
+  auto& s = stats();
+  s.num_requests++; s.num_allocs++;
+  s.bytes_requested += numElems*sizeof(ScalarType); s.bytes_allocated += numElems*sizeof(ScalarType);
+  return new ScalarType[numElems];
+}
+
+template<typename ScalarType>
+void StandardAllocator::_deallocate(ScalarType* ptr){
+  delete[] ptr;
+}
+
+inline allocator_stats& StandardAllocator::stats(){
+  static allocator_stats s = {0,0,0,0};
+  return s;
+}
+
+inline void StandardAllocator::reset_stats(){
+  stats() = {0,0,0,0};
+}
+
+
+template<typename ScalarType, typename DimensionType>
+ScalarType* HugePageAllocator::_allocate(DimensionType numElems){
+  auto& s = stats();
+  size_t bytes = std::max(size_t(numElems*sizeof(ScalarType)),size_t(1));
+  bool huge = bytes >= huge_page_size;
+  if (huge){ bytes = ((bytes + huge_page_size - 1)/huge_page_size)*huge_page_size; }
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, huge ? huge_page_size : cache_line_size, bytes) != 0){ throw std::bad_alloc(); }
+#ifdef MADV_HUGEPAGE
+  if (huge){ madvise(ptr, bytes, MADV_HUGEPAGE); }
+#endif
+  s.num_requests++; s.num_allocs++;
+  s.bytes_requested += numElems*sizeof(ScalarType); s.bytes_allocated += bytes;
+  return (ScalarType*)ptr;
+}
+
+template<typename ScalarType>
+void HugePageAllocator::_deallocate(ScalarType* ptr){
+  std::free(ptr);
+}
+
+inline allocator_stats& HugePageAllocator::stats(){
+  static allocator_stats s = {0,0,0,0};
+  return s;
+}
+
+inline void HugePageAllocator::reset_stats(){
+  stats() = {0,0,0,0};
+}
+
+
+template<typename ScalarType, typename DimensionType>
+ScalarType* PoolAllocator::_allocate(DimensionType numElems){
+  auto& s = stats();
+  size_t class_bytes;
+  size_t size_class = get_class(header_size + numElems*sizeof(ScalarType), class_bytes);
+  s.num_requests++; s.bytes_requested += numElems*sizeof(ScalarType);
+  auto& list = free_list(size_class);
+  char* block;
+  if (list.size() > 0){
+    block = (char*)list.back(); list.pop_back();
+  }
+  else{
+    block = (char*)std::malloc(class_bytes);
+    if (block == nullptr){ throw std::bad_alloc(); }
+    s.num_allocs++; s.bytes_allocated += class_bytes;
+  }
+  *((size_t*)block) = size_class;
+  return (ScalarType*)(block+header_size);
+}
+
+template<typename ScalarType>
+void PoolAllocator::_deallocate(ScalarType* ptr){
+  char* block = ((char*)ptr)-header_size;
+  free_list(*((size_t*)block)).push_back(block);
+}
+
+inline allocator_stats& PoolAllocator::stats(){
+  static allocator_stats s = {0,0,0,0};
+  return s;
+}
+
+inline void PoolAllocator::reset_stats(){
+  stats() = {0,0,0,0};
+}
+
+inline void PoolAllocator::release(){
+  for (size_t i=0; i<num_classes; i++){
+    auto& list = free_list(i);
+    for (auto block : list){ std::free(block); }
+    list.clear();
+  }
+}
+
+inline size_t PoolAllocator::get_class(size_t bytes, size_t& class_bytes){
+  // Four classes per power of two, so at most 25% of each buffer is wasted
+  bytes = std::max(bytes,size_t(2*header_size));
+  size_t k = 63 - __builtin_clzll(bytes);
+  if (bytes == (size_t(1)<<k)){ class_bytes = bytes; return 4*k; }
+  size_t step = size_t(1)<<(k-2);
+  size_t sub = (bytes - (size_t(1)<<k) + step - 1)/step;
+  class_bytes = (size_t(1)<<k) + sub*step;
+  return 4*k+sub;
+}
+
+inline std::vector<void*>& PoolAllocator::free_list(size_t size_class){
+  static std::vector<std::vector<void*>> lists(num_classes);
+  return lists[size_class];
+}
+
+
+template<typename ScalarType, typename DimensionType>
+ScalarType* MappedAllocator::_allocate(DimensionType numElems){
+  static size_t counter = 0;
+  auto& s = stats();
+  size_t bytes = header_size + numElems*sizeof(ScalarType);
+  s.num_requests++; s.num_allocs++;
+  s.bytes_requested += numElems*sizeof(ScalarType); s.bytes_allocated += bytes;
+  // Small buffers are not worth a file and a mapping of their own; a header size of 0 marks them as heap-allocated
+  if (bytes < min_mapped_size){
+    char* block = (char*)std::malloc(bytes);
+    if (block == nullptr){ throw std::bad_alloc(); }
+    *((size_t*)block) = 0;
+    return (ScalarType*)(block+header_size);
+  }
+  std::string path = directory() + "/capital_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0){ throw std::system_error(errno, std::generic_category(), "MappedAllocator: open " + path); }
+  unlink(path.c_str());		// the mapping keeps the file alive until munmap
+  if (ftruncate(fd, bytes) != 0){ int err = errno; close(fd); throw std::system_error(err, std::generic_category(), "MappedAllocator: ftruncate " + path); }
+  void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED){ int err = errno; close(fd); throw std::system_error(err, std::generic_category(), "MappedAllocator: mmap " + path); }
+  close(fd);
+  *((size_t*)ptr) = bytes;
+  return (ScalarType*)((char*)ptr+header_size);
+}
+
+template<typename ScalarType>
+void MappedAllocator::_deallocate(ScalarType* ptr){
+  char* block = ((char*)ptr)-header_size;
+  size_t bytes = *((size_t*)block);
+  if (bytes == 0){ std::free(block); }
+  else{ munmap(block, bytes); }
+}
+
+inline allocator_stats& MappedAllocator::stats(){
+  static allocator_stats s = {0,0,0,0};
+  return s;
+}
+
+inline void MappedAllocator::reset_stats(){
+  stats() = {0,0,0,0};
+}
+
+inline void MappedAllocator::_prefetch(const void* ptr, size_t bytes){
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t start = ((size_t)ptr/page_size)*page_size;
+  madvise((void*)start, (size_t)ptr + bytes - start, MADV_WILLNEED);
+}
+
+inline std::string& MappedAllocator::directory(){
+  static std::string dir = (std::getenv("CAPITAL_MMAP_DIR") != nullptr ? std::getenv("CAPITAL_MMAP_DIR") : "/var/tmp");
+  return dir;
+}
@@ -4,9 +4,11 @@
 #define MATRIX_H_
 
 // Local includes -- the policy classes
+#include "allocator.h"
+#include "random.h"
 #include "structure.h"
 
-template<typename ScalarType = double, typename DimensionType = int64_t, typename StructurePolicy = rect, typename OffloadPolicy = OffloadEachGemm>
+template<typename ScalarType = double, typename DimensionType = int64_t, typename StructurePolicy = rect, typename OffloadPolicy = OffloadEachGemm, typename AllocatorPolicy = StandardAllocator>
 class matrix : public StructurePolicy{
 public:
   // Type traits (some inherited from matrixBase)
@@ -14,6 +16,7 @@ public:
   using DimensionType = DimensionType;
   using StructureType = StructurePolicy;
   using OffloadType = OffloadPolicy;
+  using AllocatorType = AllocatorPolicy;
 
   explicit matrix(){this->filled=false; this->danger=true; this->_data=nullptr; this->_scratch=nullptr; this->_pad=nullptr;}// = delete;
   explicit matrix(DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t globalPgridX, int64_t globalPgridY);	// Regular constructor
@@ -32,16 +35,19 @@ public:
   void _destroy_();
   void _restrict_(DimensionType startX, DimensionType endX, DimensionType startY, DimensionType endY);
   void _derestrict_();
+  void _borrow_(ScalarType* scratch, ScalarType* pad);
+  void _return_();
 
   // automatically inlined
   // returning an lvalue by virtue of its reference type -- note: this isnt the safest thing, but it provides better speed. 
   inline ScalarType*& data() { return this->_data; }
   inline ScalarType* data() const { return this->_data; }
   //inline ScalarType* get_data() { ScalarType* data = this->_data; this->_data=nullptr; return data; }	// only to be used if internal pointer is needed and instance is never to be used again
-  inline ScalarType*& scratch() { return this->_scratch; }
-  inline ScalarType* scratch() const { return this->_scratch; }
-  inline ScalarType*& pad() { return this->_pad; }
-  inline ScalarType* pad() const { return this->_pad; }
+  // scratch and pad are allocated on first use, as most instances never need them
+  inline ScalarType*& scratch() { if (this->_scratch==nullptr) _lazy_scratch_(); return this->_scratch; }
+  inline ScalarType* scratch() const { if (this->_scratch==nullptr) _lazy_scratch_(); return this->_scratch; }
+  inline ScalarType*& pad() { if (this->_pad==nullptr) _lazy_pad_(); return this->_pad; }
+  inline ScalarType* pad() const { if (this->_pad==nullptr) _lazy_pad_(); return this->_pad; }
   inline DimensionType num_elems() const { return this->_numElems; }
   inline DimensionType num_elems(DimensionType rangeX, DimensionType rangeY) const { return _num_elems(rangeX, rangeY); }
   inline DimensionType num_rows_local() const { return this->_dimensionY; }
@@ -70,14 +76,23 @@ public:
   void print_data() const;
   void print_scratch() const;
   void print_pad() const;
+  // Collective checkpointing via MPI-IO. The file holds a header followed by the global matrix in the structure's packed column-major format,
+  //   so it can be reloaded on any process grid. comm must hold exactly one copy of the matrix when saving (e.g. a single slice of a replicated grid).
+  void save(const char* file, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, MPI_Comm comm) const;
+  void load(const char* file, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, MPI_Comm comm);
 
 private:
   void copy(const matrix& rhs);
   void mover(matrix&& rhs);
+  void _lazy_scratch_() const;
+  void _lazy_pad_() const;
+  void _file_types_(MPI_Datatype& memoryType, MPI_Datatype& fileType, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY) const;
+
+  static constexpr int64_t header_size = 8;	// int64_t entries: magic, version, structure, sizeof(ScalarType), global columns, global rows, 2 reserved
 
   ScalarType* _data;				// Where the matrix data lives as a contiguous 1d array
-  ScalarType* _scratch;				// Extra storage for summa and other computations that require one2all and all2one communications
-  ScalarType* _pad;				// Extra storage for uppertri and lowertri structures only used in avoiding extra allocations in summa
+  mutable ScalarType* _scratch;			// Extra storage for summa and other computations that require one2all and all2one communications
+  mutable ScalarType* _pad;			// Extra storage for uppertri and lowertri structures only used in avoiding extra allocations in summa
   bool allocated_data;				// Asks if the raw data was allocated by the user or ourselves
   bool filled;					// Tracks whether the matrix instance has been filled with data in the 2-part construction
   bool danger;					// notifies me if default constructor was used.
@@ -94,6 +109,13 @@ private:
   DimensionType _numElems_;			// Number of elements in matrix
   DimensionType _dimensionX_;			// Number of columns owned locally
   DimensionType _dimensionY_;			// Number of rows owned locally
+
+  // Special members for _borrow_ and _return_ methods
+  ScalarType* _data_own_;
+  ScalarType* _scratch_own_;
+  ScalarType* _pad_own_;
+  bool borrowed_scratch = false;		// Tracks whether scratch/pad point into an external workspace rather than buffers we own
+  bool borrowed_pad = false;
 };
 
 #include "matrix.hpp"
@@ -2,8 +2,8 @@
 
 // #include "matrix.h"  -> Compiler needs the full definition of the templated class in order to instantiate it.
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t globalPgridX, int64_t globalPgridY){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::matrix(DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t globalPgridX, int64_t globalPgridY){
   // Extra padding of zeros is at most 1 in either dimension
   int64_t pHelper = globalDimensionX%globalPgridX;
   this->_dimensionX = {globalDimensionX/globalPgridX + (pHelper ? 1 : 0)};
@@ -13,13 +13,13 @@ matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(Dimension
   this->_globalDimensionX = {globalDimensionX};
   this->_globalDimensionY = {globalDimensionY};
 
-  _assemble(this->_data, this->_scratch, this->_pad, this->_numElems, this->_dimensionX, this->_dimensionY);
+  StructurePolicy::template _assemble<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, this->_numElems, this->_dimensionX, this->_dimensionY);
   this->allocated_data=true; this->filled=true;
   return;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, DimensionType globalPgridX, DimensionType globalPgridY){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::matrix(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, DimensionType globalPgridX, DimensionType globalPgridY){
   // Idea: move the data argument into this_data, and then set up the matrix rows (this_matrix)
   // Note that the owner of data and positions should be aware that the vectors they pass in will be destroyed and the data sucked out upon return.
 
@@ -38,19 +38,19 @@ matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(ScalarTyp
   // Reason: sometimes, I just want to enter in an empty vector that will be filled up in Serializer. Other times, I want to truly
   //   assemble a vector for use somewhere else.
   if ((this->_data == nullptr) || (!valid)){
-    _assemble(this->_data, this->_scratch, this->_pad, this->_numElems, dimensionX, dimensionY);
+    StructurePolicy::template _assemble<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, this->_numElems, dimensionX, dimensionY);
     this->allocated_data=true;
   }
   else{
     // No longer supporting cheap copies if pointer is valid, because the algorithm internals take extreme liberties in optimizations
-    _copy(this->_data, this->_scratch, this->_pad, data, this->_dimensionX, this->_dimensionY);
+    StructurePolicy::template _copy<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, data, this->_dimensionX, this->_dimensionY);
     this->allocated_data=true;
   }
   this->filled=true;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalPgridX, DimensionType globalPgridY){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::matrix(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalPgridX, DimensionType globalPgridY){
   // Idea: move the data argument into this_data, and then set up the matrix rows (this_matrix)
   // Note that the owner of data and positions should be aware that the vectors they pass in will be destroyed and the data sucked out upon return.
 
@@ -63,45 +63,46 @@ matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(ScalarTyp
   this->_data = data;					// will get overwritten if necessary
 
   if (data != nullptr){
-    _assemble_matrix(this->_data, this->_scratch, this->_pad, this->_dimensionX, this->_dimensionY);
+    StructurePolicy::template _assemble_matrix<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, this->_dimensionX, this->_dimensionY);
     this->allocated_data=false;
   }
   else{
-    _assemble(this->_data, this->_scratch, this->_pad, this->_numElems, this->_dimensionX, this->_dimensionY);
+    StructurePolicy::template _assemble<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, this->_numElems, this->_dimensionX, this->_dimensionY);
     this->allocated_data=true;
   }
   this->filled=true;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalPgridX, DimensionType globalPgridY, bool){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::matrix(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalPgridX, DimensionType globalPgridY, bool){
   this->_dimensionX = {dimensionX};
   this->_dimensionY = {dimensionY};
   this->_globalDimensionX = {dimensionX*globalPgridX};
   this->_globalDimensionY = {dimensionY*globalPgridY};
   this->_numElems = num_elems(dimensionX, dimensionY);	// will get overwritten if necessary
   this->_data = data;					// will get overwritten if necessary
+  this->_scratch = nullptr; this->_pad = nullptr;
   this->allocated_data=false;
   this->filled=false;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(const matrix& rhs){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::matrix(const matrix& rhs){
   copy(rhs);
   this->filled=true;
   return;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::matrix(matrix&& rhs){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::matrix(matrix&& rhs){
   // DimensionTypese std::forward in the future.
   mover(std::move(rhs));
   this->filled=true;
   return;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>& matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::operator=(const matrix& rhs){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>& matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::operator=(const matrix& rhs){
   if (this != &rhs){
     copy(rhs);
   }
@@ -109,8 +110,8 @@ matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>& matrix<ScalarTyp
   return *this;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>& matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::operator=(matrix&& rhs){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>& matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::operator=(matrix&& rhs){
   if (this != &rhs){
     mover(std::move(rhs));
   }
@@ -118,28 +119,28 @@ matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>& matrix<ScalarTyp
   return *this;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::~matrix(){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::~matrix(){
   this->_destroy_();
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::_fill_(){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_fill_(){
   if (!this->filled){
     if (this->_data != nullptr){
-      _assemble_matrix(this->_data, this->_scratch, this->_pad, this->_dimensionX, this->_dimensionY);
+      StructurePolicy::template _assemble_matrix<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, this->_dimensionX, this->_dimensionY);
       this->allocated_data=false;
     }
     else{
-      _assemble(this->_data, this->_scratch, this->_pad, this->_numElems, this->_dimensionX, this->_dimensionY);
+      StructurePolicy::template _assemble<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, this->_numElems, this->_dimensionX, this->_dimensionY);
       this->allocated_data=true;
     }
     this->filled=true;
   }
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::_register_(DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t globalPgridX, int64_t globalPgridY){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_register_(DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t globalPgridX, int64_t globalPgridY){
   if (!this->filled){
     // Extra padding of zeros is at most 1 in either dimension
     int64_t pHelper = globalDimensionX%globalPgridX;
@@ -154,46 +155,66 @@ void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::_register_(
   }
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::_destroy_(){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_destroy_(){
   // Actually, now that we are purly using vectors, I don't think we need to delete anything. Once the instance
   //   of the class goes out of scope, the vector data gets deleted automatically.
   if (this->filled){
-    if (this->_scratch != nullptr){ delete[] this->_scratch; this->_scratch=nullptr;}	// could add an assert here for StructurePolicy==lowertri,uppertri
-    if (this->_pad != nullptr){ delete[] this->_pad; this->_pad=nullptr;}	// could add an assert here for StructurePolicy==lowertri,uppertri
-    if (this->allocated_data && (this->_data != nullptr)){ delete[] this->_data; this->_data=nullptr;}
+    if (this->_scratch != nullptr){ AllocatorPolicy::_deallocate(this->_scratch); this->_scratch=nullptr;}	// could add an assert here for StructurePolicy==lowertri,uppertri
+    if (this->_pad != nullptr){ AllocatorPolicy::_deallocate(this->_pad); this->_pad=nullptr;}	// could add an assert here for StructurePolicy==lowertri,uppertri
+    if (this->allocated_data && (this->_data != nullptr)){ AllocatorPolicy::_deallocate(this->_data); this->_data=nullptr;}
     this->allocated_data=false;
     this->filled=false;
   }
   this->filled=false;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::_restrict_(DimensionType startX, DimensionType endX, DimensionType startY, DimensionType endY){
-  this->_data_=this->_data; this->_scratch_=this->_scratch; this->_dimensionX_=this->_dimensionX; this->_dimensionY_=this->_dimensionY; this->_numElems_=this->_numElems;
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_restrict_(DimensionType startX, DimensionType endX, DimensionType startY, DimensionType endY){
+  this->_data_=this->_data; this->_scratch_=this->scratch(); this->_dimensionX_=this->_dimensionX; this->_dimensionY_=this->_dimensionY; this->_numElems_=this->_numElems;
   this->_data=&this->_data_[offset_local(startX,startY)]; this->_scratch=&this->_scratch_[offset_local(startX,startY)]; this->_dimensionX=endX-startX; this->_dimensionY=endY-startY; this->_numElems=num_elems(endX-startX,endY-startY);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::_derestrict_(){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_derestrict_(){
   this->_data=this->_data_; this->_scratch=this->_scratch_; this->_dimensionX=this->_dimensionX_; this->_dimensionY=this->_dimensionY_; this->_numElems=this->_numElems_;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::copy(const matrix& rhs){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_borrow_(ScalarType* scratch, ScalarType* pad){
+  // Only buffers that have not been allocated yet are borrowed
+  if (this->borrowed_scratch || this->borrowed_pad) return;
+  this->_data_own_=this->_data; this->_scratch_own_=this->_scratch; this->_pad_own_=this->_pad;
+  if (this->_scratch == nullptr){ this->_scratch=scratch; this->borrowed_scratch=true; }
+  if (this->_pad == nullptr && pad != nullptr){ this->_pad=pad; this->borrowed_pad=true; }
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_return_(){
+  if (!this->borrowed_scratch && !this->borrowed_pad) return;
+  // Output may have been swapped into a borrowed buffer, in which case it is copied back into the buffer we own
+  if (this->_data != this->_data_own_){ std::memcpy(this->_data_own_, this->_data, this->_numElems*sizeof(ScalarType)); }
+  this->_data=this->_data_own_;
+  this->_scratch = this->borrowed_scratch ? nullptr : this->_scratch_own_;
+  this->_pad = this->borrowed_pad ? nullptr : this->_pad_own_;
+  this->borrowed_scratch=false; this->borrowed_pad=false;
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::copy(const matrix& rhs){
   this->_dimensionX = {rhs._dimensionX};
   this->_dimensionY = {rhs._dimensionY};
   this->_numElems = {rhs._numElems};
   this->_globalDimensionX = {rhs._globalDimensionX};
   this->_globalDimensionY = {rhs._globalDimensionY};
-  _copy(this->_data, this->_scratch, this->_pad, rhs._data, this->_dimensionX, this->_dimensionY);
+  StructurePolicy::template _copy<AllocatorPolicy>(this->_data, this->_scratch, this->_pad, rhs._data, this->_dimensionX, this->_dimensionY);
   this->allocated_data=true;
   this->filled=true;
   return;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::mover(matrix&& rhs){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::mover(matrix&& rhs){
   assert(rhs.allocated_data);	// we don't support "move"ing from pointer-generated matrix instances
   this->_dimensionX = {rhs._dimensionX};
   this->_dimensionY = {rhs._dimensionY};
@@ -210,46 +231,105 @@ void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::mover(matri
   return;
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::distribute_random(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, int64_t key){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_lazy_scratch_() const{
+  StructurePolicy::template _assemble_scratch<AllocatorPolicy>(this->_scratch, this->_dimensionX, this->_dimensionY);
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_lazy_pad_() const{
+  StructurePolicy::template _assemble_pad<AllocatorPolicy>(this->_pad, this->_dimensionX, this->_dimensionY);
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::distribute_random(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, int64_t key){
   // matrix must be already constructed with memory. Add a check for this later.
   _distribute_random(this->_data,this->_dimensionX,this->_dimensionY,this->_globalDimensionX,this->_globalDimensionY,localPgridX,localPgridY,globalPgridX,globalPgridY,key);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::distribute_symmetric(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, int64_t key, bool diagonallyDominant){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::distribute_symmetric(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, int64_t key, bool diagonallyDominant){
   // matrix must be already constructed with memory. Add a check for this later.
   _distribute_symmetric(this->_data,this->_dimensionX,this->_dimensionY,this->_globalDimensionX,this->_globalDimensionY,localPgridX,localPgridY,globalPgridX,globalPgridY,key,diagonallyDominant);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::distribute_identity(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, ScalarType val){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::distribute_identity(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, ScalarType val){
   // matrix must be already constructed with memory. Add a check for this later.
   _distribute_identity(this->_data,this->_dimensionX,this->_dimensionY,this->_globalDimensionX,this->_globalDimensionY,localPgridX,localPgridY,globalPgridX,globalPgridY,val);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::distribute_debug(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY){
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::distribute_debug(int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY){
   // matrix must be already constructed with memory. Add a check for this later.
   _distribute_debug(this->_data,this->_dimensionX,this->_dimensionY,this->_globalDimensionX,this->_globalDimensionY,localPgridX,localPgridY,globalPgridX,globalPgridY);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::print() const{
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::print() const{
   _print(this->_data,this->_dimensionX,this->_dimensionY);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::print_data() const{
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::print_data() const{
   _print(this->_data,this->_dimensionX,this->_dimensionY);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::print_scratch() const{
-  _print(this->_scratch,this->_dimensionX,this->_dimensionY);
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::print_scratch() const{
+  _print(this->scratch(),this->_dimensionX,this->_dimensionY);
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::print_pad() const{
+  rect::_print(this->pad(),this->_dimensionX,this->_dimensionY);
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::save(const char* file, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, MPI_Comm comm) const{
+  int rank; MPI_Comm_rank(comm,&rank);
+  int64_t header[header_size] = {0x4c415449504143,1,StructurePolicy::_structure_id,int64_t(sizeof(ScalarType)),int64_t(this->_globalDimensionX),int64_t(this->_globalDimensionY),0,0};
+  MPI_File fh; MPI_Datatype memoryType,fileType;
+  MPI_File_open(comm, file, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+  MPI_File_set_size(fh, header_size*sizeof(int64_t) + StructurePolicy::_num_elems(this->_globalDimensionX,this->_globalDimensionY)*sizeof(ScalarType));
+  if (rank==0){ MPI_File_write_at(fh, 0, header, header_size, MPI_INT64_T, MPI_STATUS_IGNORE); }
+  _file_types_(memoryType,fileType,localPgridX,localPgridY,globalPgridX,globalPgridY);
+  MPI_File_set_view(fh, header_size*sizeof(int64_t), mpi_type<ScalarType>::type, fileType, "native", MPI_INFO_NULL);
+  MPI_File_write_all(fh, this->_data, 1, memoryType, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+  MPI_Type_free(&memoryType); MPI_Type_free(&fileType);
+}
+
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::load(const char* file, int64_t localPgridX, int64_t localPgridY, int64_t globalPgridX, int64_t globalPgridY, MPI_Comm comm){
+  // matrix must be already constructed with the global dimensions stored in the file
+  int64_t header[header_size];
+  MPI_File fh; MPI_Datatype memoryType,fileType;
+  MPI_File_open(comm, file, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+  MPI_File_read_at_all(fh, 0, header, header_size, MPI_INT64_T, MPI_STATUS_IGNORE);
+  assert(header[0] == 0x4c415449504143 && header[1] == 1);
+  assert(header[2] == StructurePolicy::_structure_id && header[3] == int64_t(sizeof(ScalarType)));
+  assert(header[4] == int64_t(this->_globalDimensionX) && header[5] == int64_t(this->_globalDimensionY));
+  StructurePolicy::_zero(this->_data,this->_dimensionX,this->_dimensionY);		// padding is not stored in the file
+  _file_types_(memoryType,fileType,localPgridX,localPgridY,globalPgridX,globalPgridY);
+  MPI_File_set_view(fh, header_size*sizeof(int64_t), mpi_type<ScalarType>::type, fileType, "native", MPI_INFO_NULL);
+  MPI_File_read_all(fh, this->_data, 1, memoryType, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+  MPI_Type_free(&memoryType); MPI_Type_free(&fileType);
 }
 
-template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy>
-void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy>::print_pad() const{
-  rect::_print(this->_pad,this->_dimensionX,this->_dimensionY);
+template<typename ScalarType, typename DimensionType, typename StructurePolicy, typename OffloadPolicy, typename AllocatorPolicy>
+void matrix<ScalarType,DimensionType,StructurePolicy,OffloadPolicy,AllocatorPolicy>::_file_types_(MPI_Datatype& memoryType, MPI_Datatype& fileType, int64_t localPgridX, int64_t localPgridY,
+                                                                                                  int64_t globalPgridX, int64_t globalPgridY) const{
+  std::vector<int> counts; std::vector<MPI_Aint> memoryOffsets, fileOffsets;
+  StructurePolicy::_file_view(counts,memoryOffsets,fileOffsets,this->_dimensionX,this->_dimensionY,this->_globalDimensionX,this->_globalDimensionY,localPgridX,localPgridY,globalPgridX,globalPgridY);
+  for (auto& it : memoryOffsets){ it *= sizeof(ScalarType); }
+  for (auto& it : fileOffsets){ it *= sizeof(ScalarType); }
+  // Consecutive elements of a local column sit globalPgridY elements apart in the file
+  MPI_Datatype strided;
+  MPI_Type_create_resized(mpi_type<ScalarType>::type, 0, globalPgridY*sizeof(ScalarType), &strided);
+  MPI_Type_create_hindexed(counts.size(), counts.size()>0 ? &counts[0] : nullptr, counts.size()>0 ? &memoryOffsets[0] : nullptr, mpi_type<ScalarType>::type, &memoryType);
+  MPI_Type_create_hindexed(counts.size(), counts.size()>0 ? &counts[0] : nullptr, counts.size()>0 ? &fileOffsets[0] : nullptr, strided, &fileType);
+  MPI_Type_commit(&memoryType); MPI_Type_commit(&fileType);
+  MPI_Type_free(&strided);
 }
@@ -0,0 +1,22 @@
+/* Author: Edward Hutter */
+
+#ifndef MATRIX_RANDOM_H_
+#define MATRIX_RANDOM_H_
+
+// Counter-based generator (Philox4x32-10) used by the Structure Policy to fill distributed matrices
+//   Each element is a pure function of (key, global column, global row), so the generated matrix does not depend on the
+//   process grid, the replication factor, or the order in which elements are visited.
+class philox{
+public:
+  static inline uint64_t _bits(uint64_t key, uint64_t coordX, uint64_t coordY);
+  template<typename ScalarType>
+  static inline ScalarType _uniform(uint64_t key, uint64_t coordX, uint64_t coordY);	// uniform in [0,1), in each component for complex types
+  template<typename ScalarType>
+  static inline ScalarType _symmetric(uint64_t key, uint64_t coordX, uint64_t coordY);	// element (x,y) is element (y,x), conjugated for complex types
+private:
+  static inline uint32_t mulhilo(uint32_t a, uint32_t b, uint32_t& hi);
+};
+
+#include "random.hpp"
+
+#endif /* MATRIX_RANDOM_H_ */
@@ -0,0 +1,52 @@
+/* Author: Edward Hutter */
+
+inline uint32_t philox::mulhilo(uint32_t a, uint32_t b, uint32_t& hi){
+  uint64_t product = uint64_t(a)*uint64_t(b);
+  hi = uint32_t(product>>32);
+  return uint32_t(product);
+}
+
+inline uint64_t philox::_bits(uint64_t key, uint64_t coordX, uint64_t coordY){
+  uint32_t c0 = uint32_t(coordY); uint32_t c1 = uint32_t(coordY>>32);
+  uint32_t c2 = uint32_t(coordX); uint32_t c3 = uint32_t(coordX>>32);
+  uint32_t k0 = uint32_t(key); uint32_t k1 = uint32_t(key>>32);
+  // Ten rounds, with no data-dependent branches so that loops over a column vectorize
+  for (int r=0; r<10; r++){
+    uint32_t hi0,hi1;
+    uint32_t lo0 = mulhilo(0xD2511F53,c0,hi0);
+    uint32_t lo1 = mulhilo(0xCD9E8D57,c2,hi1);
+    c0 = hi1^c1^k0; c1 = lo1;
+    c2 = hi0^c3^k1; c3 = lo0;
+    k0 += 0x9E3779B9; k1 += 0xBB67AE85;
+  }
+  return (uint64_t(c1)<<32) | uint64_t(c0);
+}
+
+template<>
+inline double philox::_uniform<double>(uint64_t key, uint64_t coordX, uint64_t coordY){
+  return (_bits(key,coordX,coordY)>>11)*(1./9007199254740992.);		// 53 random bits
+}
+
+template<>
+inline float philox::_uniform<float>(uint64_t key, uint64_t coordX, uint64_t coordY){
+  return (_bits(key,coordX,coordY)>>40)*(1.f/16777216.f);			// 24 random bits
+}
+
+// The imaginary part is drawn from a second stream, obtained by flipping the top bit of the key
+template<>
+inline std::complex<float> philox::_uniform<std::complex<float>>(uint64_t key, uint64_t coordX, uint64_t coordY){
+  return std::complex<float>(_uniform<float>(key,coordX,coordY),_uniform<float>(key^(uint64_t(1)<<63),coordX,coordY));
+}
+
+template<>
+inline std::complex<double> philox::_uniform<std::complex<double>>(uint64_t key, uint64_t coordX, uint64_t coordY){
+  return std::complex<double>(_uniform<double>(key,coordX,coordY),_uniform<double>(key^(uint64_t(1)<<63),coordX,coordY));
+}
+
+// Generating from the (min,max) coordinate pair makes element (x,y) identical to element (y,x). Complex matrices are made Hermitian:
+//   the element below the diagonal is the conjugate of its mirror, and diagonal elements are real.
+template<typename ScalarType>
+inline ScalarType philox::_symmetric(uint64_t key, uint64_t coordX, uint64_t coordY){
+  ScalarType val = _uniform<ScalarType>(key,std::min(coordX,coordY),std::max(coordX,coordY));
+  return (coordX == coordY ? ScalarType(std::real(val)) : (coordY > coordX ? conjugate(val) : val));
+}
@@ -9,6 +9,83 @@
   TODO: Future: Do we need to deal with changing between distributions? Maybe add this to the Distributer Policy?
 */
 
+// Bytes copied by every serialize specialization since the last reset, so drivers can report the copy volume of an algorithm
+class serialize_stats{
+public:
+  static size_t& bytes();
+  static void reset();
+};
+
+// Kernels behind every serialize specialization. Copy segments are split over OpenMP threads once a copy is large enough to amortize
+//   the fork, and copies larger than the last-level cache use non-temporal stores so they do not evict the operands of the next BLAS call
+class serialize_kernel{
+public:
+  static size_t& thread_threshold();
+  static size_t& stream_threshold();
+  template<typename T, typename U>
+  static void copy(T* dest, const T* src, U count, bool stream);
+  template<typename T, typename U>
+  static void zero(T* dest, U count, bool stream);
+
+private:
+  template<typename T, typename U>
+  static void _stream_copy(T* dest, const T* src, U count);
+  template<typename T, typename U>
+  static void _stream_zero(T* dest, U count);
+#ifdef __SSE2__
+  template<typename U>
+  static void _stream_copy(double* dest, const double* src, U count);
+  template<typename U>
+  static void _stream_zero(double* dest, U count);
+  template<typename U>
+  static void _stream_copy(float* dest, const float* src, U count);
+  template<typename U>
+  static void _stream_zero(float* dest, U count);
+#endif
+};
+
+// A serialize call reduced to a list of copy and zero-fill segments. Plans are keyed by the structure pair, the layout of both buffers,
+//   and the index ranges; each is built on the first call and replayed on every later one, so the ranges that recur within a
+//   factorization skip the per-column offset arithmetic. The cache is per thread and holds at most max_plans plans, evicting the
+//   least recently used; factorizations clear it when they return.
+class serialize_plan{
+public:
+  struct segment{
+    int64_t src;
+    int64_t dest;
+    int64_t count;
+    int64_t src_stride;
+    int64_t dest_stride;
+    int64_t fill;		// zeros written contiguously after the copied destination elements
+  };
+  using key_type = std::array<int64_t,18>;
+
+  void copy(int64_t src, int64_t dest, int64_t count, int64_t src_stride=1, int64_t dest_stride=1);
+  void zero(int64_t dest, int64_t count);
+  template<typename T>
+  void replay(const T* s, T* d) const;
+
+  template<typename BuildType>
+  static const serialize_plan& fetch(const key_type& key, BuildType&& build);
+  static void clear();
+  static size_t size();
+
+  size_t copied = 0;				// elements copied, as reported to serialize_stats
+  size_t written = 0;				// elements copied or zeroed
+  int64_t src_first = std::numeric_limits<int64_t>::max();	// touched windows, for the allocator prefetch hook
+  int64_t src_last = 0;
+  int64_t dest_first = std::numeric_limits<int64_t>::max();
+  int64_t dest_last = 0;
+
+private:
+  std::vector<segment> _segments;
+
+  static constexpr size_t max_plans = 4096;
+  static std::map<key_type,std::pair<serialize_plan,std::list<key_type>::iterator>>& cache();
+  static std::list<key_type>& recency();	// most recently used first
+  static size_t& epoch();	// advanced by clear() and by evictions, which invalidates the per-call-site memos
+};
+
 // Fully templated class is declared, not defined
 template<typename Structure1, typename Structure2>
 class serialize;
@@ -37,6 +114,7 @@ public:
                      typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer=0, size_t dest_buffer=0);
 };
 
+// Packed-to-rect copies also zero the opposite triangle of the destination region, in the same pass over each column
 template<>
 class serialize<uppertri,rect>{
 public:
@@ -69,6 +147,38 @@ public:
                      typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer=0, size_t dest_buffer=0);
 };
 
+// An rfp region is an upper triangle; only its storage differs, which the column copies account for
+template<>
+class serialize<rfp,rect> : public serialize<uppertri,rect>{};
+
+template<>
+class serialize<rfp,rfp> : public serialize<uppertri,uppertri>{};
+
+// Conversions between column-major and tile-major rect storage copy each column in runs that end at tile boundaries
+template<int64_t TileSize>
+class serialize<rect,tiled<TileSize>>{
+public:
+  template<typename SrcType, typename DestType>
+  static void invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                     typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer=0, size_t dest_buffer=0);
+};
+
+template<int64_t TileSize>
+class serialize<tiled<TileSize>,rect>{
+public:
+  template<typename SrcType, typename DestType>
+  static void invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                     typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer=0, size_t dest_buffer=0);
+};
+
+template<int64_t TileSize>
+class serialize<tiled<TileSize>,tiled<TileSize>>{
+public:
+  template<typename SrcType, typename DestType>
+  static void invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                     typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer=0, size_t dest_buffer=0);
+};
+
 #include "serialize.hpp"
 
 #endif /* MATRIX_SERIALIZE_H_ */
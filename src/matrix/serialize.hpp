@@ -1,150 +1,336 @@
 /* Author: Edward Hutter */
 
 
-// Helper static method -- fills a range with zeros
+inline size_t& serialize_stats::bytes(){
+  static size_t b = 0;
+  return b;
+}
+
+inline void serialize_stats::reset(){
+  bytes() = 0;
+}
+
+// Helper static method -- hints to the allocator that the elements [firstIdx,lastIdx) of a buffer are about to be touched
+template<typename MatrixType, typename T, typename U>
+static void prefetchRange(const MatrixType& M, T* addr, U firstIdx, U lastIdx){
+  if (lastIdx > firstIdx) MatrixType::AllocatorType::_prefetch(&addr[firstIdx],(lastIdx-firstIdx)*sizeof(T));
+}
+
+// Copies totalling fewer bytes stay on the calling thread
+inline size_t& serialize_kernel::thread_threshold(){
+  static size_t b = size_t(1)<<18;
+  return b;
+}
+
+// Copies totalling at least this many bytes bypass the cache on store
+inline size_t& serialize_kernel::stream_threshold(){
+  static size_t b = size_t(1)<<23;
+  return b;
+}
+
+template<typename T, typename U>
+void serialize_kernel::copy(T* dest, const T* src, U count, bool stream){
+  if (count <= 0) return;
+  if (stream) _stream_copy(dest,src,count);
+  else memcpy(dest,src,count*sizeof(T));
+}
+
+template<typename T, typename U>
+void serialize_kernel::zero(T* dest, U count, bool stream){
+  if (count <= 0) return;
+  if (stream) _stream_zero(dest,count);
+  else std::fill_n(dest,count,T(0));
+}
+
+// Scalar types without a streaming store fall back to the cached path
+template<typename T, typename U>
+void serialize_kernel::_stream_copy(T* dest, const T* src, U count){
+  memcpy(dest,src,count*sizeof(T));
+}
+
 template<typename T, typename U>
-static void fillZerosContig(T* addr, U size){
-  for (U i=0; i<size; i++){
-    addr[i] = 0;
+void serialize_kernel::_stream_zero(T* dest, U count){
+  std::fill_n(dest,count,T(0));
+}
+
+#ifdef __SSE2__
+// Streaming stores need a 16-byte aligned destination, so the leading and trailing elements are written through the cache.
+//   The fence orders this thread's streamed stores before anything it writes afterwards.
+template<typename U>
+void serialize_kernel::_stream_copy(double* dest, const double* src, U count){
+  U i=0;
+  for (; (i<count) && (reinterpret_cast<size_t>(&dest[i]) & 15); i++){ dest[i] = src[i]; }
+  for (; i+2<=count; i+=2){ _mm_stream_pd(&dest[i],_mm_loadu_pd(&src[i])); }
+  for (; i<count; i++){ dest[i] = src[i]; }
+  _mm_sfence();
+}
+
+template<typename U>
+void serialize_kernel::_stream_zero(double* dest, U count){
+  U i=0;
+  for (; (i<count) && (reinterpret_cast<size_t>(&dest[i]) & 15); i++){ dest[i] = 0; }
+  for (; i+2<=count; i+=2){ _mm_stream_pd(&dest[i],_mm_setzero_pd()); }
+  for (; i<count; i++){ dest[i] = 0; }
+  _mm_sfence();
+}
+
+template<typename U>
+void serialize_kernel::_stream_copy(float* dest, const float* src, U count){
+  U i=0;
+  for (; (i<count) && (reinterpret_cast<size_t>(&dest[i]) & 15); i++){ dest[i] = src[i]; }
+  for (; i+4<=count; i+=4){ _mm_stream_ps(&dest[i],_mm_loadu_ps(&src[i])); }
+  for (; i<count; i++){ dest[i] = src[i]; }
+  _mm_sfence();
+}
+
+template<typename U>
+void serialize_kernel::_stream_zero(float* dest, U count){
+  U i=0;
+  for (; (i<count) && (reinterpret_cast<size_t>(&dest[i]) & 15); i++){ dest[i] = 0; }
+  for (; i+4<=count; i+=4){ _mm_stream_ps(&dest[i],_mm_setzero_ps()); }
+  for (; i<count; i++){ dest[i] = 0; }
+  _mm_sfence();
+}
+#endif
+
+// Segments that continue the previous one are merged up to this many elements, which keeps large copies split finely enough to thread
+static constexpr int64_t plan_merge_limit = int64_t(1)<<15;
+
+inline void serialize_plan::copy(int64_t src, int64_t dest, int64_t count, int64_t src_stride, int64_t dest_stride){
+  if (count <= 0) return;
+  if (count == 1){ src_stride=1; dest_stride=1; }
+  segment* last = (_segments.empty() ? nullptr : &_segments.back());
+  if ((last != nullptr) && (last->fill==0) && (last->count>0) && (src_stride==1) && (dest_stride==1) && (last->src_stride==1) && (last->dest_stride==1) &&
+      (last->src+last->count==src) && (last->dest+last->count==dest) && (last->count+count<=plan_merge_limit)){
+    last->count += count;
   }
+  else{ _segments.push_back(segment{src,dest,count,src_stride,dest_stride,0}); }
+  this->copied += count; this->written += count;
+  this->src_first = std::min(this->src_first,std::min(src,src+(count-1)*src_stride)); this->src_last = std::max(this->src_last,std::max(src,src+(count-1)*src_stride)+1);
+  this->dest_first = std::min(this->dest_first,std::min(dest,dest+(count-1)*dest_stride)); this->dest_last = std::max(this->dest_last,std::max(dest,dest+(count-1)*dest_stride)+1);
 }
 
-template<typename SrcType, typename DestType>
-void serialize<rect,rect>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
-                                  typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
+// A zero-fill that starts where the previous segment's destination ends is folded into that segment
+inline void serialize_plan::zero(int64_t dest, int64_t count){
+  if (count <= 0) return;
+  segment* last = (_segments.empty() ? nullptr : &_segments.back());
+  if ((last != nullptr) && (last->dest_stride==1) && (last->dest+last->count+last->fill==dest) && (last->count+last->fill+count<=plan_merge_limit)){
+    last->fill += count;
+  }
+  else{ _segments.push_back(segment{0,dest,0,1,1,count}); }
+  this->written += count;
+  this->dest_first = std::min(this->dest_first,dest); this->dest_last = std::max(this->dest_last,dest+count);
+}
+
+// Segments are independent, so they are dealt round-robin to threads; column lengths of a triangle vary too much for contiguous blocks
+template<typename T>
+void serialize_plan::replay(const T* s, T* d) const{
+  size_t volume = this->written*sizeof(T); bool stream = volume >= serialize_kernel::stream_threshold();
+  int64_t numSegments = _segments.size();
+  #pragma omp parallel for schedule(static,1) if(volume >= serialize_kernel::thread_threshold())
+  for (int64_t i=0; i<numSegments; i++){
+    const segment& seg = _segments[i];
+    if ((seg.src_stride==1) && (seg.dest_stride==1)){ serialize_kernel::copy(&d[seg.dest],&s[seg.src],seg.count,stream); }
+    else{ for (int64_t j=0; j<seg.count; j++){ d[seg.dest+j*seg.dest_stride] = s[seg.src+j*seg.src_stride]; } }
+    serialize_kernel::zero(&d[seg.dest+seg.count],seg.fill,stream);
+  }
+}
+
+// Every call site has its own build functor type, and so its own memo of the plan it replayed last; recursive algorithms mostly
+//   repeat the previous ranges at a given call site, which then skips the lookup. The memo, like the cache, is per thread.
+template<typename BuildType>
+const serialize_plan& serialize_plan::fetch(const key_type& key, BuildType&& build){
+  static thread_local key_type last_key; static thread_local const serialize_plan* last_plan = nullptr; static thread_local size_t last_epoch = 0;
+  if ((last_plan != nullptr) && (last_epoch == epoch()) && (last_key == key)) return *last_plan;
+  auto& c = cache(); auto& order = recency();
+  auto it = c.find(key);
+  if (it == c.end()){
+    // Evicting the least recently used plan may invalidate a memo, so it advances the epoch
+    if (c.size() >= max_plans){ c.erase(order.back()); order.pop_back(); epoch()++; }
+    order.push_front(key);
+    it = c.emplace(key,std::make_pair(serialize_plan(),order.begin())).first;
+    build(it->second.first);
+  }
+  else{ order.splice(order.begin(),order,it->second.second); }
+  last_key = key; last_plan = &it->second.first; last_epoch = epoch();
+  return it->second.first;
+}
+
+inline void serialize_plan::clear(){
+  cache().clear(); recency().clear();
+  epoch()++;
+}
+
+inline size_t& serialize_plan::epoch(){
+  static thread_local size_t e = 0;
+  return e;
+}
+
+inline size_t serialize_plan::size(){
+  return cache().size();
+}
+
+inline std::map<serialize_plan::key_type,std::pair<serialize_plan,std::list<serialize_plan::key_type>::iterator>>& serialize_plan::cache(){
+  static thread_local std::map<key_type,std::pair<serialize_plan,std::list<key_type>::iterator>> c;
+  return c;
+}
+
+inline std::list<serialize_plan::key_type>& serialize_plan::recency(){
+  static thread_local std::list<key_type> r;
+  return r;
+}
+
+// Helper static method -- records count consecutive rows of one column. These are contiguous in every layout but rfp, where the columns
+//   left of the middle are stored as rows and so form a strided run; anything less regular is recorded one element at a time.
+template<typename SrcType, typename DestType, typename U>
+static void planRun(serialize_plan& plan, const SrcType& src, U sx, U sy, size_t src_buffer, const DestType& dest, U dx, U dy, size_t dest_buffer, U count){
+  if (count <= 0) return;
+  int64_t src_idx = src.offset_local(sx,sy,src_buffer); int64_t dest_idx = dest.offset_local(dx,dy,dest_buffer);
+  int64_t src_stride = (count>1 ? src.offset_local(sx,sy+1,src_buffer)-src_idx : 1); int64_t dest_stride = (count>1 ? dest.offset_local(dx,dy+1,dest_buffer)-dest_idx : 1);
+  bool regular = true;
+  for (U j=2; (j<count) && regular; j++){
+    regular = (src.offset_local(sx,sy+j,src_buffer)-src_idx == j*src_stride) && (dest.offset_local(dx,dy+j,dest_buffer)-dest_idx == j*dest_stride);
+  }
+  if (regular){ plan.copy(src_idx,dest_idx,count,src_stride,dest_stride); }
+  else{
+    for (U j=0; j<count; j++){ plan.copy(src.offset_local(sx,sy+j,src_buffer),dest.offset_local(dx,dy+j,dest_buffer),1); }
+  }
+}
+
+// Helper static method -- records a rect region column by column, in runs that stop at the tile boundaries of either side (a tile size of 0 denotes column-major storage)
+template<typename SrcType, typename DestType, typename U>
+static void planTiles(serialize_plan& plan, const SrcType& src, U ssx, U ssy, size_t src_buffer, const DestType& dest, U dsx, U dsy, size_t dest_buffer, U rangeX, U rangeY, U srcTile, U destTile){
+  for (U i=0; i<rangeX; i++){
+    for (U j=0; j<rangeY;){
+      U len = rangeY-j;
+      if (srcTile>0) len = std::min(len,srcTile-(ssy+j)%srcTile);
+      if (destTile>0) len = std::min(len,destTile-(dsy+j)%destTile);
+      plan.copy(src.offset_local(ssx+i,ssy+j,src_buffer),dest.offset_local(dsx+i,dsy+j,dest_buffer),len);
+      j += len;
+    }
+  }
+}
+
+// Helper static method -- replays the plan of a serialize call, building it with `build` the first time its key is seen. The key holds
+//   the structure pair, the layout of both buffers (structure, dimensions, column stride), and the index ranges.
+template<typename SrcStructure, typename DestStructure, typename SrcType, typename DestType, typename U, typename BuildType>
+static void execute(const SrcType& src, DestType& dest, U ssx, U sex, U ssy, U sey, U dsx, U dex, U dsy, U dey, size_t src_buffer, size_t dest_buffer, BuildType&& build){
 #ifdef FUNCTION_SYMBOLS
 CRITTER_START(serialize);
 #endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
+  using T = typename SrcType::ScalarType;
   assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
+  serialize_plan::key_type key = {{SrcStructure::_structure_id, DestStructure::_structure_id,
+                                   SrcType::StructureType::_structure_id, int64_t(src.num_columns_local()), int64_t(src.num_rows_local()), int64_t(src.offset_local(1,0,src_buffer)), src_buffer==2,
+                                   DestType::StructureType::_structure_id, int64_t(dest.num_columns_local()), int64_t(dest.num_rows_local()), int64_t(dest.offset_local(1,0,dest_buffer)), dest_buffer==2,
+                                   ssx, sex, ssy, sey, dsx, dsy}};
+  const serialize_plan& plan = serialize_plan::fetch(key,build);
   T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
   T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],rangeY*sizeof(T));
-  }
+  prefetchRange(src,s,plan.src_first,plan.src_last);
+  prefetchRange(dest,d,plan.dest_first,plan.dest_last);
+  plan.replay(s,d);
+  serialize_stats::bytes() += plan.copied*sizeof(T);
 #ifdef FUNCTION_SYMBOLS
 CRITTER_STOP(serialize);
 #endif
 }
 
+template<typename SrcType, typename DestType>
+void serialize<rect,rect>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                                  typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
+  using U = typename SrcType::DimensionType;
+  execute<rect,rect>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){ planRun(plan,src,ssx+i,ssy,src_buffer,dest,dsx+i,dsy,dest_buffer,U(sey-ssy)); }
+  });
+}
+
 template<typename SrcType, typename DestType>
 void serialize<rect,uppertri>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
                                       typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
-#ifdef FUNCTION_SYMBOLS
-CRITTER_START(serialize);
-#endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
-  assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
-  T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
-  T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],(i+1)*sizeof(T));
-  }
-#ifdef FUNCTION_SYMBOLS
-CRITTER_STOP(serialize);
-#endif
+  using U = typename SrcType::DimensionType;
+  execute<rect,uppertri>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){ planRun(plan,src,ssx+i,ssy,src_buffer,dest,dsx+i,dsy,dest_buffer,U(i+1)); }
+  });
 }
 
 template<typename SrcType, typename DestType>
 void serialize<rect,lowertri>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
                                       typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
-#ifdef FUNCTION_SYMBOLS
-CRITTER_START(serialize);
-#endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
-  assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
-  T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
-  T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy+i,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy+i,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],(rangeY-i)*sizeof(T));
-  }
-#ifdef FUNCTION_SYMBOLS
-CRITTER_STOP(serialize);
-#endif
+  using U = typename SrcType::DimensionType;
+  execute<rect,lowertri>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){ planRun(plan,src,ssx+i,ssy+i,src_buffer,dest,dsx+i,dsy+i,dest_buffer,U(sey-ssy-i)); }
+  });
 }
 
 template<typename SrcType, typename DestType>
 void serialize<uppertri,rect>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
                                       typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
-#ifdef FUNCTION_SYMBOLS
-CRITTER_START(serialize);
-#endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
-  assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
-  T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
-  T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],(i+1)*sizeof(T));
-  }
-#ifdef FUNCTION_SYMBOLS
-CRITTER_STOP(serialize);
-#endif
+  using U = typename SrcType::DimensionType;
+  execute<uppertri,rect>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){
+      planRun(plan,src,ssx+i,ssy,src_buffer,dest,dsx+i,dsy,dest_buffer,U(i+1));
+      plan.zero(dest.offset_local(dsx+i,dsy+i+1,dest_buffer),sey-ssy-i-1);
+    }
+  });
 }
 
 template<typename SrcType, typename DestType>
 void serialize<uppertri,uppertri>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
                                           typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
-#ifdef FUNCTION_SYMBOLS
-CRITTER_START(serialize);
-#endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
-  assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
-  T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
-  T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],(i+1)*sizeof(T));
-  }
-#ifdef FUNCTION_SYMBOLS
-CRITTER_STOP(serialize);
-#endif
+  using U = typename SrcType::DimensionType;
+  execute<uppertri,uppertri>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){ planRun(plan,src,ssx+i,ssy,src_buffer,dest,dsx+i,dsy,dest_buffer,U(i+1)); }
+  });
 }
 
 template<typename SrcType, typename DestType>
 void serialize<lowertri,rect>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
                                       typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
-#ifdef FUNCTION_SYMBOLS
-CRITTER_START(serialize);
-#endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
-  assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
-  T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
-  T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy+i,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy+i,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],(rangeY-i)*sizeof(T));
-  }
-#ifdef FUNCTION_SYMBOLS
-CRITTER_STOP(serialize);
-#endif
+  using U = typename SrcType::DimensionType;
+  execute<lowertri,rect>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){
+      plan.zero(dest.offset_local(dsx+i,dsy,dest_buffer),i);
+      planRun(plan,src,ssx+i,ssy+i,src_buffer,dest,dsx+i,dsy+i,dest_buffer,U(sey-ssy-i));
+    }
+  });
 }
 
 template<typename SrcType, typename DestType>
 void serialize<lowertri,lowertri>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
                                           typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
-#ifdef FUNCTION_SYMBOLS
-CRITTER_START(serialize);
-#endif
-  using T = typename SrcType::ScalarType; using U = typename SrcType::DimensionType;
-  assert((sex-ssx)==(dex-dsx)); assert((sey-ssy)==(dey-dsy));
-  U rangeX = sex-ssx; U rangeY = sey-ssy;
-  T* s; if (src_buffer==0) s=src.data(); else if (src_buffer==1) s=src.scratch(); else s=src.pad();
-  T* d; if (dest_buffer==0) d=dest.data(); else if (dest_buffer==1) d=dest.scratch(); else d=dest.pad();
-  for (U i=0; i<rangeX; i++){
-    U dest_idx = dest.offset_local(dsx+i,dsy+i,dest_buffer); U src_idx = src.offset_local(ssx+i,ssy+i,src_buffer);
-    memcpy(&d[dest_idx],&s[src_idx],(rangeY-i)*sizeof(T));
-  }
-#ifdef FUNCTION_SYMBOLS
-CRITTER_STOP(serialize);
-#endif
+  using U = typename SrcType::DimensionType;
+  execute<lowertri,lowertri>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    for (U i=0; i<sex-ssx; i++){ planRun(plan,src,ssx+i,ssy+i,src_buffer,dest,dsx+i,dsy+i,dest_buffer,U(sey-ssy-i)); }
+  });
+}
+
+template<int64_t TileSize>
+template<typename SrcType, typename DestType>
+void serialize<rect,tiled<TileSize>>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                             typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
+  using U = typename SrcType::DimensionType;
+  execute<rect,tiled<TileSize>>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    planTiles(plan,src,ssx,ssy,src_buffer,dest,dsx,dsy,dest_buffer,U(sex-ssx),U(sey-ssy),U(0),U(TileSize));
+  });
+}
+
+template<int64_t TileSize>
+template<typename SrcType, typename DestType>
+void serialize<tiled<TileSize>,rect>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                             typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
+  using U = typename SrcType::DimensionType;
+  execute<tiled<TileSize>,rect>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    planTiles(plan,src,ssx,ssy,src_buffer,dest,dsx,dsy,dest_buffer,U(sex-ssx),U(sey-ssy),U(TileSize),U(0));
+  });
+}
+
+template<int64_t TileSize>
+template<typename SrcType, typename DestType>
+void serialize<tiled<TileSize>,tiled<TileSize>>::invoke(const SrcType& src, DestType& dest, typename SrcType::DimensionType ssx, typename SrcType::DimensionType sex, typename SrcType::DimensionType ssy, typename SrcType::DimensionType sey,
+                             typename SrcType::DimensionType dsx, typename SrcType::DimensionType dex, typename SrcType::DimensionType dsy, typename SrcType::DimensionType dey, size_t src_buffer, size_t dest_buffer){
+  using U = typename SrcType::DimensionType;
+  execute<tiled<TileSize>,tiled<TileSize>>(src,dest,ssx,sex,ssy,sey,dsx,dex,dsy,dey,src_buffer,dest_buffer,[&](serialize_plan& plan){
+    planTiles(plan,src,ssx,ssy,src_buffer,dest,dsx,dsy,dest_buffer,U(sex-ssx),U(sey-ssy),U(TileSize),U(TileSize));
+  });
 }
@@ -7,18 +7,28 @@
 
 class rect{
 public:
+  static constexpr int64_t _structure_id = 0;	// recorded in checkpoint headers
   template<typename DimensionType>
   static inline DimensionType _num_elems(DimensionType rangeX, DimensionType rangeY) { return rangeX*rangeY; }
   template<typename DimensionType>
   static inline DimensionType _offset(DimensionType coordX, DimensionType coordY, DimensionType dimX, DimensionType dimY) { return coordX*dimY+coordY; }
   template<typename ScalarType, typename DimensionType>
   static void _print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY);
-protected:
   template<typename ScalarType, typename DimensionType>
+  static void _zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY);
+protected:
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY);
-  template<typename ScalarType, typename DimensionType>
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
-  template<typename ScalarType, typename DimensionType>
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename DimensionType>
+  static void _file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                         DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY);
   template<typename ScalarType, typename DimensionType>
   void _distribute_identity(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
@@ -33,18 +43,28 @@ protected:
 
 class uppertri{
 public:
+  static constexpr int64_t _structure_id = 1;	// recorded in checkpoint headers
   template<typename DimensionType>
   static inline DimensionType _num_elems(DimensionType rangeX, DimensionType rangeY) { return ((rangeX*(rangeX+1))>>1); }
   template<typename DimensionType>
   static inline DimensionType _offset(DimensionType coordX, DimensionType coordY, DimensionType dimX, DimensionType dimY) { return ((coordX*(coordX+1))>>1)+coordY; }
   template<typename ScalarType, typename DimensionType>
   static void _print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY);
-protected:
   template<typename ScalarType, typename DimensionType>
+  static void _zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY);
+protected:
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY);
-  template<typename ScalarType, typename DimensionType>
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
-  template<typename ScalarType, typename DimensionType>
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename DimensionType>
+  static void _file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                         DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY);
   template<typename ScalarType, typename DimensionType>
   static void _distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY,
@@ -53,24 +73,111 @@ protected:
 
 class lowertri{
 public:
+  static constexpr int64_t _structure_id = 2;	// recorded in checkpoint headers
   template<typename DimensionType>
   static inline DimensionType _num_elems(DimensionType rangeX, DimensionType rangeY) { return ((rangeX*(rangeX+1))>>1); }
   template<typename DimensionType>
   static inline DimensionType _offset(DimensionType coordX, DimensionType coordY, DimensionType dimX, DimensionType dimY) { return coordX*dimY+coordY-(coordX*(coordX+1)/2); }
   template<typename ScalarType, typename DimensionType>
   static void _print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY);
-protected:
   template<typename ScalarType, typename DimensionType>
+  static void _zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY);
+protected:
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY);
-  template<typename ScalarType, typename DimensionType>
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename DimensionType>
+  static void _file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                         DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY);
   template<typename ScalarType, typename DimensionType>
+  static void _distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY,
+                                 int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key);
+};
+
+// Upper-triangular matrices in Rectangular Full Packed format: the same n(n+1)/2 elements as uppertri, arranged as an ld x n2 column-major
+//   array (n1=n/2, n2=n-n1, ld=n+1 if n is even, else n) holding the rectangle A(0:n1,n1:n) at row 0, the triangle A(n1:n,n1:n) at row n1,
+//   and the transpose of the triangle A(0:n1,0:n1) at row n1+1. Each piece has a leading dimension, so BLAS-3 operates on the packed storage directly.
+class rfp{
+public:
+  static constexpr int64_t _structure_id = 3;	// recorded in checkpoint headers
+  template<typename DimensionType>
+  static inline DimensionType _num_elems(DimensionType rangeX, DimensionType rangeY) { return ((rangeX*(rangeX+1))>>1); }
+  template<typename DimensionType>
+  static inline DimensionType _offset(DimensionType coordX, DimensionType coordY, DimensionType dimX, DimensionType dimY) {
+    return coordX >= (dimX>>1) ? (coordX-(dimX>>1))*_ld(dimX)+coordY : coordY*_ld(dimX)+(dimX>>1)+1+coordX; }
+  template<typename DimensionType>
+  static inline DimensionType _ld(DimensionType dim) { return (dim&1) ? dim : dim+1; }
+  template<typename ScalarType, typename DimensionType>
+  static void _print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename ScalarType, typename DimensionType>
+  static void _zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY);
+protected:
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename DimensionType>
+  static void _file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                         DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
   static void _copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY);
   template<typename ScalarType, typename DimensionType>
   static void _distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY,
                                  int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key);
 };
 
+// Rect matrices stored tile-major: TileSize x TileSize column-major tiles, each contiguous, ordered column-major over the tile grid.
+//   Edge tiles are trimmed rather than padded, so a local block holds exactly dimX*dimY elements and a tile's leading dimension is its height.
+//   This is a storage format only: a tiled matrix converts to and from rect through serialize and can be generated, printed and
+//   checkpointed, but the algorithms (summa, cholinv, cacqr) operate on column-major blocks and take tiled operands only via a rect copy.
+template<int64_t TileSize = 64>
+class tiled{
+public:
+  static constexpr int64_t _structure_id = 4 + (TileSize << 8);	// recorded in checkpoint headers and serialize plan keys, so it distinguishes tile sizes
+  static constexpr int64_t _tile_size = TileSize;
+  template<typename DimensionType>
+  static inline DimensionType _num_elems(DimensionType rangeX, DimensionType rangeY) { return rangeX*rangeY; }
+  template<typename DimensionType>
+  static inline DimensionType _offset(DimensionType coordX, DimensionType coordY, DimensionType dimX, DimensionType dimY) {
+    DimensionType tileX = coordX-coordX%TileSize; DimensionType tileY = coordY-coordY%TileSize;
+    return tileX*dimY + tileY*std::min(DimensionType(TileSize),dimX-tileX) + (coordX-tileX)*std::min(DimensionType(TileSize),dimY-tileY) + (coordY-tileY); }
+  template<typename ScalarType, typename DimensionType>
+  static void _print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename ScalarType, typename DimensionType>
+  static void _zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY);
+protected:
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename DimensionType>
+  static void _file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                         DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY);
+  template<typename AllocatorType, typename ScalarType, typename DimensionType>
+  static void _copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY);
+  template<typename ScalarType, typename DimensionType>
+  static void _distribute_symmetric(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
+                                    int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key, bool diagonallyDominant);
+  template<typename ScalarType, typename DimensionType>
+  static void _distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
+                                 int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key);
+};
+
 #include "structure.hpp"
 
 #endif /* MATRIX_STRUCTURE_H_ */
@@ -1,28 +1,66 @@
 /* Author: Edward Hutter */
 
-template<typename ScalarType, typename DimensionType>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void rect::_assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY){
   matrixNumElems = dimensionX * dimensionY;
-  data = new ScalarType[matrixNumElems];
-  std::memset(data,0,matrixNumElems*sizeof(ScalarType));
-  _assemble_matrix(data, scratch, pad, dimensionX, dimensionY);
+  data = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(data, dimensionX, dimensionY);
+  _assemble_matrix<AllocatorType>(data, scratch, pad, dimensionX, dimensionY);
 }
 
-template<typename ScalarType, typename DimensionType>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void rect::_assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
-  DimensionType matrixNumElems = dimensionX * dimensionY;
-  scratch = new ScalarType[matrixNumElems];
-  std::memset(scratch,0,matrixNumElems*sizeof(ScalarType));
+  // scratch and pad are allocated lazily on first use (see matrix::scratch() and matrix::pad())
+  scratch = nullptr;
   pad = nullptr;
 }
 
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rect::_assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType matrixNumElems = dimensionX * dimensionY;
+  scratch = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(scratch, dimensionX, dimensionY);
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rect::_assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  pad = nullptr;	// rect never needs a non-packed copy
+}
+
 template<typename ScalarType, typename DimensionType>
+void rect::_zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY){
+#ifdef FIRST_TOUCH
+  // Each column is zeroed (and thus its pages placed) by the thread that the static column partition of the threaded kernels assigns it to
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<dimensionX; i++){
+    std::fill_n(&buffer[i*dimensionY],dimensionY,ScalarType(0));
+  }
+#else
+  std::fill_n(buffer,dimensionX*dimensionY,ScalarType(0));
+#endif
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void rect::_copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY){
   DimensionType numElems = 0;
-  _assemble(data, scratch, pad, numElems, dimensionX, dimensionY);
+  _assemble<AllocatorType>(data, scratch, pad, numElems, dimensionX, dimensionY);
   std::memcpy(&data[0], &source[0], numElems*sizeof(ScalarType));
 }
 
+template<typename DimensionType>
+void rect::_file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                      DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY){
+  // One block per local column: contiguous in memory, strided by globalPgridDimY in the (column-major) file
+  DimensionType numRows = (localPgridDimY < globalDimensionY ? std::min(dimensionY,(globalDimensionY-localPgridDimY+globalPgridDimY-1)/globalPgridDimY) : 0);
+  for (DimensionType i=0; i<dimensionX; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    if ((globalPositionX >= globalDimensionX) || (numRows == 0)) break;
+    counts.push_back(numRows);
+    memoryOffsets.push_back(_offset(i,DimensionType(0),dimensionX,dimensionY));
+    fileOffsets.push_back(_offset(globalPositionX,DimensionType(localPgridDimY),globalDimensionX,globalDimensionY));
+  }
+}
+
 template<typename ScalarType, typename DimensionType>
 void rect::_print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY){
   for (DimensionType i=0; i<dimensionY; i++){
@@ -69,29 +107,21 @@ template<typename ScalarType, typename DimensionType>
 void rect::_distribute_symmetric(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
                                  int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key, bool diagonallyDominant){
 
-  srand48(key);
   int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
   int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
-  DimensionType saveGlobalPositionX = localPgridDimX;
-  DimensionType saveGlobalPositionY = localPgridDimY;
+  #pragma omp parallel for schedule(static)
   for (DimensionType i=0; i<padXlen; i++){
-    saveGlobalPositionY = localPgridDimY;
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    #pragma omp simd
     for (DimensionType j=0; j<padYlen; j++){
-      if (saveGlobalPositionX > saveGlobalPositionY){
-        srand48(saveGlobalPositionX + globalDimensionY*saveGlobalPositionY);
-      }
-      else{
-        srand48(saveGlobalPositionY + globalDimensionY*saveGlobalPositionX);
-      }
-      data[i*dimensionY+j] = drand48();			// Change this later.
-      if ((diagonallyDominant) && (saveGlobalPositionX == saveGlobalPositionY) && (i==j)){
-        data[i*dimensionY+j] += globalDimensionX;		// X or Y, should not matter
-      }
-      saveGlobalPositionY += globalPgridDimY;
+      DimensionType globalPositionY = localPgridDimY + j*globalPgridDimY;
+      data[i*dimensionY+j] = philox::_symmetric<ScalarType>(key,globalPositionX,globalPositionY);
+    }
+    if ((diagonallyDominant) && (globalPositionX >= localPgridDimY) && ((globalPositionX-localPgridDimY) % globalPgridDimY == 0) && ((globalPositionX-localPgridDimY)/globalPgridDimY < padYlen)){
+      data[i*dimensionY+(globalPositionX-localPgridDimY)/globalPgridDimY] += globalDimensionX;		// X or Y, should not matter
     }
     // check for padding
     if (padYlen != dimensionY) { data[i*dimensionY+dimensionY-1] = 0; }
-    saveGlobalPositionX += globalPgridDimX;
   }
   // check for padding
   if (padXlen != dimensionX){
@@ -105,19 +135,17 @@ void rect::_distribute_symmetric(ScalarType* data, DimensionType dimensionX, Dim
 template<typename ScalarType, typename DimensionType>
 void rect::_distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
                               int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key){
-  srand48(key);
-  DimensionType saveGlobalPosition = localPgridDimY + localPgridDimX*globalDimensionY;		// Watch for 64-bit problems later with temporaries being implicitely casted.
   int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
   int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
+  #pragma omp parallel for schedule(static)
   for (DimensionType i=0; i<padXlen; i++){
-    DimensionType globalPosition = saveGlobalPosition;
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    #pragma omp simd
     for (DimensionType j=0; j<padYlen; j++){
-      data[i*dimensionY+j] = drand48();			// Change this later.
-      globalPosition += globalPgridDimY;
+      data[i*dimensionY+j] = philox::_uniform<ScalarType>(key,globalPositionX,localPgridDimY + j*globalPgridDimY);
     }
     // check for padding
     if (padYlen != dimensionY) { data[i*dimensionY+dimensionY-1] = 0; }
-    saveGlobalPosition += (globalPgridDimX*globalDimensionY);
   }
   // check for padding
   if (padXlen != dimensionX){
@@ -129,31 +157,69 @@ void rect::_distribute_random(ScalarType* data, DimensionType dimensionX, Dimens
 }
 
 
-template<typename ScalarType, typename DimensionType>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void uppertri::_assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY){
   matrixNumElems = ((dimensionY*(dimensionY+1))>>1);		// dimensionX == dimensionY
-  data = new ScalarType[matrixNumElems];
-  std::memset(data,0,matrixNumElems*sizeof(ScalarType));
-  _assemble_matrix(data, scratch, pad, dimensionX, dimensionY);
+  data = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(data, dimensionX, dimensionY);
+  _assemble_matrix<AllocatorType>(data, scratch, pad, dimensionX, dimensionY);
 }
 
-template<typename ScalarType, typename DimensionType>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void uppertri::_assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
-  DimensionType nonPackedNumElems = dimensionX*dimensionY;
+  // scratch and pad are allocated lazily on first use (see matrix::scratch() and matrix::pad())
+  scratch = nullptr;
+  pad = nullptr;
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void uppertri::_assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY){
   DimensionType matrixNumElems = ((dimensionY*(dimensionY+1))>>1);		// dimensionX == dimensionY
-  scratch = new ScalarType[matrixNumElems];
-  std::memset(scratch,0,matrixNumElems*sizeof(ScalarType));
-  pad = new ScalarType[nonPackedNumElems];
-  std::memset(pad,0,matrixNumElems*sizeof(ScalarType));
+  scratch = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(scratch, dimensionX, dimensionY);
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void uppertri::_assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType nonPackedNumElems = dimensionX*dimensionY;
+  pad = AllocatorType::template _allocate<ScalarType>(nonPackedNumElems);
+  rect::_zero(pad, dimensionX, dimensionY);
 }
 
 template<typename ScalarType, typename DimensionType>
+void uppertri::_zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY){
+#ifdef FIRST_TOUCH
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<dimensionX; i++){
+    std::fill_n(&buffer[_offset(i,DimensionType(0),dimensionX,dimensionY)],i+1,ScalarType(0));
+  }
+#else
+  std::fill_n(buffer,_num_elems(dimensionY,dimensionY),ScalarType(0));
+#endif
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void uppertri::_copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY){
   DimensionType numElems = 0;
-  _assemble(data, scratch, pad, numElems, dimensionX, dimensionY);
+  _assemble<AllocatorType>(data, scratch, pad, numElems, dimensionX, dimensionY);
   std::memcpy(&data[0], &source[0], numElems*sizeof(ScalarType));
 }
 
+template<typename DimensionType>
+void uppertri::_file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                          DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY){
+  // The file holds the global matrix in packed upper-triangular format. Local column i stores rows [0,i], of which those on or above the global diagonal are written.
+  for (DimensionType i=0; i<dimensionX; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    if (globalPositionX >= globalDimensionX) break;
+    if (globalPositionX < localPgridDimY) continue;
+    DimensionType numRows = std::min(i+1,(globalPositionX-localPgridDimY)/globalPgridDimY+1);
+    counts.push_back(numRows);
+    memoryOffsets.push_back(_offset(i,DimensionType(0),dimensionX,dimensionY));
+    fileOffsets.push_back(_offset(globalPositionX,DimensionType(localPgridDimY),globalDimensionX,globalDimensionY));
+  }
+}
+
 template<typename ScalarType, typename DimensionType>
 void uppertri::_print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY){
   DimensionType startIter = 0;
@@ -174,27 +240,20 @@ void uppertri::_print(const ScalarType* data, DimensionType dimensionX, Dimensio
 template<typename ScalarType, typename DimensionType>
 void uppertri::_distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY,
                                   int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key){
-  srand48(key);
-  DimensionType saveGlobalPosition = localPgridDimY + localPgridDimX*globalDimensionY;		// Watch for 64-bit problems later with temporaries being implicitely casted.
   int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
   int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
-  DimensionType counter{1};
-  DimensionType startIter;
-  DimensionType endIter;
+  #pragma omp parallel for schedule(static)
   for (DimensionType i=0; i<padXlen; i++){
-    DimensionType globalPosition = saveGlobalPosition;
-    startIter = 0;
-    endIter = counter;
-    for (DimensionType j=startIter; j<endIter; j++){
-      data[_offset(i,j,dimensionX,dimensionY)] = drand48();			// Change this later.
-      globalPosition += globalPgridDimY;
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    DimensionType endIter = i+1;
+    #pragma omp simd
+    for (DimensionType j=0; j<endIter; j++){
+      data[_offset(i,j,dimensionX,dimensionY)] = philox::_uniform<ScalarType>(key,globalPositionX,localPgridDimY + j*globalPgridDimY);
     }
     // Special corner case: If a processor's first data on each row is out of bounds of the DimensionTypeT structure, then give a 0 value
     if (localPgridDimY > localPgridDimX){
-      data[_offset(i,endIter-1,dimensionX,dimensionY)] = 0;			// reset this to 0 instead of whatever was set in the last iteration of the loop above.
+      data[_offset(i,endIter-1,dimensionX,dimensionY)] = 0;			// reset this to 0 instead of whatever was set in the loop above.
     }
-    counter++;
-    saveGlobalPosition += (globalPgridDimX*globalDimensionY);
   }
   if (padXlen != dimensionX){
     // fill in the last column with zeros
@@ -206,29 +265,68 @@ void uppertri::_distribute_random(ScalarType* data, DimensionType dimensionX, Di
 }
 
 
-template<typename ScalarType, typename DimensionType>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void lowertri::_assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY){
   matrixNumElems = ((dimensionY*(dimensionY+1))>>1);
-  data = new ScalarType[matrixNumElems];
-  std::memset(data,0,matrixNumElems*sizeof(ScalarType));
-  _assemble_matrix(data, scratch, pad, dimensionX, dimensionY);
+  data = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(data, dimensionX, dimensionY);
+  _assemble_matrix<AllocatorType>(data, scratch, pad, dimensionX, dimensionY);
 }
 
-template<typename ScalarType, typename DimensionType>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void lowertri::_assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
-  DimensionType nonPackedNumElems = dimensionX*dimensionY;
+  // scratch and pad are allocated lazily on first use (see matrix::scratch() and matrix::pad())
+  scratch = nullptr;
+  pad = nullptr;
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void lowertri::_assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY){
   DimensionType matrixNumElems = ((dimensionY*(dimensionY+1))>>1);		// dimensionX == dimensionY
-  scratch = new ScalarType[matrixNumElems];
-  std::memset(scratch,0,matrixNumElems*sizeof(ScalarType));
-  pad = new ScalarType[nonPackedNumElems];
-  std::memset(pad,0,matrixNumElems*sizeof(ScalarType));
+  scratch = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(scratch, dimensionX, dimensionY);
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void lowertri::_assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType nonPackedNumElems = dimensionX*dimensionY;
+  pad = AllocatorType::template _allocate<ScalarType>(nonPackedNumElems);
+  rect::_zero(pad, dimensionX, dimensionY);
 }
 
 template<typename ScalarType, typename DimensionType>
+void lowertri::_zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY){
+#ifdef FIRST_TOUCH
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<dimensionX; i++){
+    std::fill_n(&buffer[_offset(i,i,dimensionX,dimensionY)],dimensionY-i,ScalarType(0));
+  }
+#else
+  std::fill_n(buffer,_num_elems(dimensionY,dimensionY),ScalarType(0));
+#endif
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
 void lowertri::_copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY){
   DimensionType numElems = 0;
-  _assemble(data, scratch, pad, numElems, dimensionX, dimensionY);
-  std::memcpy(&data[0], &source[0], numElems*sizeof(T));
+  _assemble<AllocatorType>(data, scratch, pad, numElems, dimensionX, dimensionY);
+  std::memcpy(&data[0], &source[0], numElems*sizeof(ScalarType));
+}
+
+template<typename DimensionType>
+void lowertri::_file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                          DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY){
+  // The file holds the global matrix in packed lower-triangular format. Local column i stores rows [i,dimensionY), of which those on or below the global diagonal are written.
+  DimensionType numRows = (localPgridDimY < globalDimensionY ? std::min(dimensionY,(globalDimensionY-localPgridDimY+globalPgridDimY-1)/globalPgridDimY) : 0);
+  for (DimensionType i=0; i<dimensionX; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    if (globalPositionX >= globalDimensionX) break;
+    DimensionType startRow = (globalPositionX > localPgridDimY ? std::max(i,(globalPositionX-localPgridDimY+globalPgridDimY-1)/globalPgridDimY) : i);
+    if (startRow >= numRows) continue;
+    counts.push_back(numRows-startRow);
+    memoryOffsets.push_back(_offset(i,startRow,dimensionX,dimensionY));
+    fileOffsets.push_back(_offset(globalPositionX,DimensionType(localPgridDimY+startRow*globalPgridDimY),globalDimensionX,globalDimensionY));
+  }
 }
 
 template<typename ScalarType, typename DimensionType>
@@ -244,41 +342,277 @@ void lowertri::_print(const ScalarType* data, DimensionType dimensionX, Dimensio
 template<typename ScalarType, typename DimensionType>
 void lowertri::_distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY,
                                   int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key){
-  srand48(key);
   int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
   int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
-  DimensionType saveGlobalPosX = localPgridDimX;
-  DimensionType saveGlobalPosY = localPgridDimY;
-  DimensionType counter{0};
+  #pragma omp parallel for schedule(static)
   for (DimensionType i=0; i<padXlen; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    DimensionType counter = i;
     // Special corner case: If a processor's last data on each row is out of bounds of the LT structure, then give a 0 value
-    counter = i;		// reset
-    saveGlobalPosY += (i*globalPgridDimY);
     if (localPgridDimY < localPgridDimX){
       // Set the last position in row
-      data[_offset(i,int64_t(0),dimensionX,dimensionY)] = 0;
+      data[_offset(i,i,dimensionX,dimensionY)] = 0;
       counter++;
-      saveGlobalPosY += globalPgridDimY;
     }
+    #pragma omp simd
     for (DimensionType j=counter; j<padYlen; j++){
-      srand48(saveGlobalPosX + globalDimensionY*saveGlobalPosY);
-      // Maybe in the future, get rid of this inner if statementand try something else? If statements in inner
-      //   nested loops can be very expensive.
-      if (saveGlobalPosX == saveGlobalPosY){
-        // Set the first position in row to a 1 -> special only to lowertri matrices.
-        data[_offset(i,j,dimensionX,dimensionY)] = 1.;
-      }
-      else{
-        data[_offset(i,j,dimensionX,dimensionY)] = drand48();
-      }
-      // check padding
-      if (padXlen != dimensionX) { data[_offset(i,dimensionY-i,dimensionX,dimensionY)] = 0; }
-      saveGlobalPosY += globalPgridDimY;
+      DimensionType globalPositionY = localPgridDimY + j*globalPgridDimY;
+      // Set the diagonal to a 1 -> special only to lowertri matrices.
+      data[_offset(i,j,dimensionX,dimensionY)] = (globalPositionX == globalPositionY ? 1. : philox::_uniform<ScalarType>(key,globalPositionX,globalPositionY));
     }
     // check padding
-    if (padXlen != dimensionX) { data[_offset(dimensionX-1,int64_t(0),dimensionX,dimensionY)] = 0; }
-    saveGlobalPosY = localPgridDimY;			// reset
-    saveGlobalPosX += globalPgridDimX;
+    if (padYlen != dimensionY) { data[_offset(i,dimensionY-1,dimensionX,dimensionY)] = 0; }
+  }
+  // check padding
+  if (padXlen != dimensionX){
+    for (DimensionType j=dimensionX-1; j<dimensionY; j++){
+      data[_offset(dimensionX-1,j,dimensionX,dimensionY)] = 0;
+    }
+  }
+  return;
+}
+
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rfp::_assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY){
+  matrixNumElems = ((dimensionY*(dimensionY+1))>>1);		// dimensionX == dimensionY
+  data = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(data, dimensionX, dimensionY);
+  _assemble_matrix<AllocatorType>(data, scratch, pad, dimensionX, dimensionY);
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rfp::_assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  // scratch and pad are allocated lazily on first use (see matrix::scratch() and matrix::pad())
+  scratch = nullptr;
+  pad = nullptr;
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rfp::_assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType matrixNumElems = ((dimensionY*(dimensionY+1))>>1);		// dimensionX == dimensionY
+  scratch = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(scratch, dimensionX, dimensionY);
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rfp::_assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  // Never holds an expanded copy of the matrix, only the diagonal blocks of a product formed before they are folded into the packed storage
+  DimensionType nonPackedNumElems = dimensionX*dimensionY;
+  pad = AllocatorType::template _allocate<ScalarType>(nonPackedNumElems);
+  rect::_zero(pad, dimensionX, dimensionY);
+}
+
+template<typename ScalarType, typename DimensionType>
+void rfp::_zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY){
+#ifdef FIRST_TOUCH
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<dimensionX-(dimensionX>>1); i++){
+    std::fill_n(&buffer[i*_ld(dimensionX)],_ld(dimensionX),ScalarType(0));
+  }
+#else
+  std::fill_n(buffer,_num_elems(dimensionY,dimensionY),ScalarType(0));
+#endif
+}
+
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void rfp::_copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType numElems = 0;
+  _assemble<AllocatorType>(data, scratch, pad, numElems, dimensionX, dimensionY);
+  std::memcpy(&data[0], &source[0], numElems*sizeof(ScalarType));
+}
+
+template<typename DimensionType>
+void rfp::_file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                     DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY){
+  // The file holds the global matrix in packed upper-triangular format, as for uppertri. Only the local columns [n/2,n) are contiguous in memory;
+  //   the elements of the others are described one at a time.
+  for (DimensionType i=0; i<dimensionX; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    if (globalPositionX >= globalDimensionX) break;
+    if (globalPositionX < localPgridDimY) continue;
+    DimensionType numRows = std::min(i+1,(globalPositionX-localPgridDimY)/globalPgridDimY+1);
+    for (DimensionType j=0; j<numRows; j += (i >= (dimensionX>>1) ? numRows : 1)){
+      counts.push_back(i >= (dimensionX>>1) ? numRows : 1);
+      memoryOffsets.push_back(_offset(i,j,dimensionX,dimensionY));
+      fileOffsets.push_back(uppertri::_offset(globalPositionX,DimensionType(localPgridDimY+j*globalPgridDimY),globalDimensionX,globalDimensionY));
+    }
+  }
+}
+
+template<typename ScalarType, typename DimensionType>
+void rfp::_print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType startIter = 0;
+  for (DimensionType i=0; i<dimensionY; i++){
+    // print spaces to represent the lower triangular zeros
+    for (DimensionType j=0; j<i; j++){
+      std::cout << "    ";
+    }
+
+    for (DimensionType j=startIter; j<dimensionX; j++){
+      std::cout << " " << data[_offset(j,i,dimensionX,dimensionY)];
+    }
+    startIter++;
+    std::cout << std::endl;
+  }
+}
+
+template<typename ScalarType, typename DimensionType>
+void rfp::_distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY,
+                             int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key){
+  int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
+  int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<padXlen; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    DimensionType endIter = i+1;
+    for (DimensionType j=0; j<endIter; j++){
+      data[_offset(i,j,dimensionX,dimensionY)] = philox::_uniform<ScalarType>(key,globalPositionX,localPgridDimY + j*globalPgridDimY);
+    }
+    // Special corner case: If a processor's first data on each row is out of bounds of the DimensionTypeT structure, then give a 0 value
+    if (localPgridDimY > localPgridDimX){
+      data[_offset(i,endIter-1,dimensionX,dimensionY)] = 0;			// reset this to 0 instead of whatever was set in the loop above.
+    }
+  }
+  if (padXlen != dimensionX){
+    // fill in the last column with zeros
+    for (DimensionType j=0; j<padYlen; j++){
+      data[_offset(dimensionX-1,j,dimensionX,dimensionY)] = 0;
+    }
+  }
+  return;
+}
+
+
+template<int64_t TileSize>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_assemble(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType& matrixNumElems, DimensionType dimensionX, DimensionType dimensionY){
+  matrixNumElems = dimensionX * dimensionY;
+  data = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(data, dimensionX, dimensionY);
+  _assemble_matrix<AllocatorType>(data, scratch, pad, dimensionX, dimensionY);
+}
+
+template<int64_t TileSize>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_assemble_matrix(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  // scratch and pad are allocated lazily on first use (see matrix::scratch() and matrix::pad())
+  scratch = nullptr;
+  pad = nullptr;
+}
+
+template<int64_t TileSize>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_assemble_scratch(ScalarType*& scratch, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType matrixNumElems = dimensionX * dimensionY;
+  scratch = AllocatorType::template _allocate<ScalarType>(matrixNumElems);
+  _zero(scratch, dimensionX, dimensionY);
+}
+
+template<int64_t TileSize>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_assemble_pad(ScalarType*& pad, DimensionType dimensionX, DimensionType dimensionY){
+  pad = nullptr;	// like rect, never needs a non-packed copy
+}
+
+template<int64_t TileSize>
+template<typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_zero(ScalarType* buffer, DimensionType dimensionX, DimensionType dimensionY){
+#ifdef FIRST_TOUCH
+  // Each column of tiles is zeroed (and thus its pages placed) by a single thread
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<dimensionX; i+=TileSize){
+    std::fill_n(&buffer[i*dimensionY],std::min(DimensionType(TileSize),dimensionX-i)*dimensionY,ScalarType(0));
+  }
+#else
+  std::fill_n(buffer,dimensionX*dimensionY,ScalarType(0));
+#endif
+}
+
+template<int64_t TileSize>
+template<typename AllocatorType, typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_copy(ScalarType*& data, ScalarType*& scratch, ScalarType*& pad, ScalarType* const & source, DimensionType dimensionX, DimensionType dimensionY){
+  DimensionType numElems = 0;
+  _assemble<AllocatorType>(data, scratch, pad, numElems, dimensionX, dimensionY);
+  std::memcpy(&data[0], &source[0], numElems*sizeof(ScalarType));
+}
+
+template<int64_t TileSize>
+template<typename DimensionType>
+void tiled<TileSize>::_file_view(std::vector<int>& counts, std::vector<MPI_Aint>& memoryOffsets, std::vector<MPI_Aint>& fileOffsets, DimensionType dimensionX, DimensionType dimensionY,
+                                 DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX, int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY){
+  // The file holds the global matrix in column-major format, as for rect. Each local column is contiguous in memory within a tile.
+  DimensionType numRows = (localPgridDimY < globalDimensionY ? std::min(dimensionY,(globalDimensionY-localPgridDimY+globalPgridDimY-1)/globalPgridDimY) : 0);
+  for (DimensionType i=0; i<dimensionX; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    if ((globalPositionX >= globalDimensionX) || (numRows == 0)) break;
+    for (DimensionType j=0; j<numRows; j+=TileSize){
+      counts.push_back(std::min(DimensionType(TileSize),numRows-j));
+      memoryOffsets.push_back(_offset(i,j,dimensionX,dimensionY));
+      fileOffsets.push_back(rect::_offset(globalPositionX,DimensionType(localPgridDimY+j*globalPgridDimY),globalDimensionX,globalDimensionY));
+    }
+  }
+}
+
+template<int64_t TileSize>
+template<typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_print(const ScalarType* data, DimensionType dimensionX, DimensionType dimensionY){
+  for (DimensionType i=0; i<dimensionY; i++){
+    for (DimensionType j=0; j<dimensionX; j++){
+      std::cout << " " << data[_offset(j,i,dimensionX,dimensionY)];
+    }
+    std::cout << std::endl;
+  }
+}
+
+template<int64_t TileSize>
+template<typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_distribute_symmetric(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
+                                            int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key, bool diagonallyDominant){
+  int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
+  int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<padXlen; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    for (DimensionType j=0; j<padYlen; j++){
+      DimensionType globalPositionY = localPgridDimY + j*globalPgridDimY;
+      data[_offset(i,j,dimensionX,dimensionY)] = philox::_symmetric<ScalarType>(key,globalPositionX,globalPositionY);
+    }
+    if ((diagonallyDominant) && (globalPositionX >= localPgridDimY) && ((globalPositionX-localPgridDimY) % globalPgridDimY == 0) && ((globalPositionX-localPgridDimY)/globalPgridDimY < padYlen)){
+      data[_offset(i,DimensionType((globalPositionX-localPgridDimY)/globalPgridDimY),dimensionX,dimensionY)] += globalDimensionX;		// X or Y, should not matter
+    }
+    // check for padding
+    if (padYlen != dimensionY) { data[_offset(i,dimensionY-1,dimensionX,dimensionY)] = 0; }
+  }
+  // check for padding
+  if (padXlen != dimensionX){
+    for (DimensionType j=0; j<dimensionY; j++){
+      data[_offset(dimensionX-1,j,dimensionX,dimensionY)] = 0;
+    }
+  }
+  return;
+}
+
+template<int64_t TileSize>
+template<typename ScalarType, typename DimensionType>
+void tiled<TileSize>::_distribute_random(ScalarType* data, DimensionType dimensionX, DimensionType dimensionY, DimensionType globalDimensionX, DimensionType globalDimensionY, int64_t localPgridDimX,
+                                         int64_t localPgridDimY, int64_t globalPgridDimX, int64_t globalPgridDimY, int64_t key){
+  int64_t padXlen = (((globalDimensionX % globalPgridDimX != 0) && ((dimensionX-1)*globalPgridDimX + localPgridDimX >= globalDimensionX)) ? dimensionX-1 : dimensionX);
+  int64_t padYlen = (((globalDimensionY % globalPgridDimY != 0) && ((dimensionY-1)*globalPgridDimY + localPgridDimY >= globalDimensionY)) ? dimensionY-1 : dimensionY);
+  #pragma omp parallel for schedule(static)
+  for (DimensionType i=0; i<padXlen; i++){
+    DimensionType globalPositionX = localPgridDimX + i*globalPgridDimX;
+    for (DimensionType j=0; j<padYlen; j++){
+      data[_offset(i,j,dimensionX,dimensionY)] = philox::_uniform<ScalarType>(key,globalPositionX,localPgridDimY + j*globalPgridDimY);
+    }
+    // check for padding
+    if (padYlen != dimensionY) { data[_offset(i,dimensionY-1,dimensionX,dimensionY)] = 0; }
+  }
+  // check for padding
+  if (padXlen != dimensionX){
+    for (DimensionType j=0; j<dimensionY; j++){
+      data[_offset(dimensionX-1,j,dimensionX,dimensionY)] = 0;
+    }
   }
   return;
 }
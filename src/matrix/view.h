@@ -0,0 +1,62 @@
+/* Author: Edward Hutter */
+
+#ifndef MATRIX_VIEW_H_
+#define MATRIX_VIEW_H_
+
+// Non-owning window onto columns [startX,endX) and rows [startY,endY) of a rect matrix's local data, addressed through the
+//   parent's leading dimension. summa accepts a view wherever it accepts a rect matrix, so sub-blocks are broadcast, multiplied,
+//   and reduced in place instead of being serialized into an intermediate and back. AllocatorPolicy must be the parent's, so that
+//   serialize issues the parent allocator's prefetch for the window.
+template<typename ScalarType = double, typename DimensionType = int64_t, typename AllocatorPolicy = StandardAllocator>
+class view{
+public:
+  using ScalarType = ScalarType;
+  using DimensionType = DimensionType;
+  using StructureType = rect;
+  using AllocatorType = AllocatorPolicy;	// never allocates; serves only the serialize prefetch hook
+
+  template<typename MatrixType>
+  explicit view(MatrixType& M, DimensionType startX, DimensionType endX, DimensionType startY, DimensionType endY);
+
+  inline ScalarType*& data() { return this->_data; }
+  inline ScalarType* data() const { return this->_data; }
+  inline ScalarType*& scratch() { return this->_scratch; }
+  inline ScalarType* scratch() const { return this->_scratch; }
+  inline ScalarType*& pad() { return this->_pad; }
+  inline ScalarType* pad() const { return this->_pad; }
+  inline DimensionType num_elems() const { return this->_dimensionX*this->_dimensionY; }
+  inline DimensionType num_rows_local() const { return this->_dimensionY; }
+  inline DimensionType num_columns_local() const { return this->_dimensionX; }
+  inline DimensionType ld() const { return this->_ld; }				// leading dimension of data()
+  inline DimensionType ld_scratch() const { return this->_ld_scratch; }		// leading dimension of scratch()
+  inline DimensionType offset_local(DimensionType coordX, DimensionType coordY, size_t buffer=0) const { return coordX*(buffer==0 ? this->_ld : (buffer==1 ? this->_ld_scratch : this->_dimensionY))+coordY; }
+
+  // data and scratch trade places along with their leading dimensions, so a root can broadcast straight out of the parent
+  inline void swap() { std::swap(this->_data,this->_scratch); std::swap(this->_ld,this->_ld_scratch); }
+  inline void swap_pad() { std::swap(this->_scratch,this->_pad); }
+
+  void _borrow_(ScalarType* scratch, ScalarType* pad);
+  void _return_();
+  bool _alias_();
+  void _pack_();
+  void _unpack_(ScalarType beta);
+  MPI_Datatype _column_type_(DimensionType numColumns) const;
+
+private:
+  ScalarType* _data;
+  ScalarType* _scratch;
+  ScalarType* _pad;
+  DimensionType _dimensionX;			// Number of columns in the window
+  DimensionType _dimensionY;			// Number of rows in the window
+  DimensionType _ld;
+  DimensionType _ld_scratch;
+};
+
+template<typename T>
+struct is_view : std::false_type{};
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+struct is_view<view<ScalarType,DimensionType,AllocatorPolicy>> : std::true_type{};
+
+#include "view.hpp"
+
+#endif /* MATRIX_VIEW_H_ */
@@ -0,0 +1,56 @@
+/* Author: Edward Hutter */
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+template<typename MatrixType>
+view<ScalarType,DimensionType,AllocatorPolicy>::view(MatrixType& M, DimensionType startX, DimensionType endX, DimensionType startY, DimensionType endY){
+  static_assert(std::is_same<typename MatrixType::StructureType,rect>::value,"views require a rect parent");
+  static_assert(std::is_same<typename MatrixType::AllocatorType,AllocatorPolicy>::value,"a view must carry its parent's allocator policy");
+  assert(endX <= M.num_columns_local()); assert(endY <= M.num_rows_local());
+  this->_ld = M.num_rows_local(); this->_data = M.data() + startX*this->_ld + startY;
+  this->_dimensionX = endX-startX; this->_dimensionY = endY-startY;
+  this->_scratch = nullptr; this->_pad = nullptr; this->_ld_scratch = this->_dimensionY;
+}
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void view<ScalarType,DimensionType,AllocatorPolicy>::_borrow_(ScalarType* scratch, ScalarType* pad){
+  this->_scratch = scratch; this->_ld_scratch = this->_dimensionY;
+}
+
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void view<ScalarType,DimensionType,AllocatorPolicy>::_return_(){
+  // data always ends up back in the parent, as a view never takes ownership of a result buffer
+  this->_scratch = nullptr; this->_ld_scratch = this->_dimensionY;
+}
+
+// When the window's columns are contiguous, scratch refers to the parent's storage itself, so an operand that is overwritten on every
+//   rank (summa output) is received, computed, and reduced in place
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+bool view<ScalarType,DimensionType,AllocatorPolicy>::_alias_(){
+  if (this->_ld != this->_dimensionY) return false;
+  this->_scratch = this->_data; this->_ld_scratch = this->_ld;
+  return true;
+}
+
+// Copies the window into a contiguous scratch
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void view<ScalarType,DimensionType,AllocatorPolicy>::_pack_(){
+  for (DimensionType i=0; i<this->_dimensionX; i++){
+    std::memcpy(&this->_scratch[i*this->_ld_scratch], &this->_data[i*this->_ld], this->_dimensionY*sizeof(ScalarType));
+  }
+}
+
+// data <- beta*data + scratch, column by column
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+void view<ScalarType,DimensionType,AllocatorPolicy>::_unpack_(ScalarType beta){
+  for (DimensionType i=0; i<this->_dimensionX; i++){
+    ScalarType* d = &this->_data[i*this->_ld]; ScalarType* s = &this->_scratch[i*this->_ld_scratch];
+    if (beta == ScalarType(0)){ std::memcpy(d, s, this->_dimensionY*sizeof(ScalarType)); }
+    else{ for (DimensionType j=0; j<this->_dimensionY; j++){ d[j] = beta*d[j] + s[j]; } }
+  }
+}
+
+// Describes numColumns consecutive columns of scratch; the type is cached and must not be freed
+template<typename ScalarType, typename DimensionType, typename AllocatorPolicy>
+MPI_Datatype view<ScalarType,DimensionType,AllocatorPolicy>::_column_type_(DimensionType numColumns) const{
+  return mpi_subtype<ScalarType>::strided(this->_dimensionY, numColumns, this->_ld_scratch);
+}
@@ -0,0 +1,78 @@
+/* Author: Edward Hutter */
+
+#ifndef UTIL_BACKEND_H_
+#define UTIL_BACKEND_H_
+
+// These class policies implement the BLAS/LAPACK Backend Policy used by blas::engine and lapack::engine
+//   Every backend supplies the CBLAS and LAPACKE interfaces, so the engines call the same routines regardless of backend.
+//   A backend differs in its headers and in how the number of threads used inside each routine is controlled.
+//   set_num_threads_local changes the count for the calling thread only where the backend allows it (MKL), and the global count
+//   otherwise, so under OpenBLAS and BLIS it affects every thread of the process; it returns the value that restores the previous
+//   setting, which blas::thread_budget does on scope exit. local_threads records which of the two applies.
+//   The backend is selected at compile time by defining one of MKL, OPENBLAS, BLIS or NETLIB (see config.mk). MKL is the default.
+
+#if defined(OPENBLAS)
+#include <cblas.h>
+#include <lapacke.h>
+#elif defined(BLIS)
+#include <blis/blis.h>
+#include <blis/cblas.h>
+#include <lapacke.h>
+#elif defined(NETLIB)
+#include <cblas.h>
+#include <lapacke.h>
+#else
+#include "mkl.h"
+// Of the supported backends only MKL provides cblas_?gemmt and cblas_?gemm_batch
+#define BACKEND_GEMMT
+#define BACKEND_GEMM_BATCH
+#endif
+
+namespace backend{
+
+#if defined(OPENBLAS)
+class openblas{
+public:
+  static const char* name(){ return "openblas"; }
+  static constexpr bool local_threads = false;
+  static int get_num_threads(){ return openblas_get_num_threads(); }
+  static void set_num_threads(int num_threads){ openblas_set_num_threads(num_threads); }
+  static int set_num_threads_local(int num_threads){ int previous = openblas_get_num_threads(); openblas_set_num_threads(num_threads); return previous; }
+};
+using active = openblas;
+#elif defined(BLIS)
+class blis{
+public:
+  static const char* name(){ return "blis"; }
+  static constexpr bool local_threads = false;
+  static int get_num_threads(){ return bli_thread_get_num_threads(); }
+  static void set_num_threads(int num_threads){ bli_thread_set_num_threads(num_threads); }
+  static int set_num_threads_local(int num_threads){ int previous = bli_thread_get_num_threads(); bli_thread_set_num_threads(num_threads); return previous; }
+};
+using active = blis;
+#elif defined(NETLIB)
+// Reference CBLAS and LAPACKE are sequential
+class netlib{
+public:
+  static const char* name(){ return "netlib"; }
+  static constexpr bool local_threads = false;
+  static int get_num_threads(){ return 1; }
+  static void set_num_threads(int num_threads){}
+  static int set_num_threads_local(int num_threads){ return 1; }
+};
+using active = netlib;
+#else
+class mkl{
+public:
+  static const char* name(){ return "mkl"; }
+  static constexpr bool local_threads = true;
+  static int get_num_threads(){ return mkl_get_max_threads(); }
+  static void set_num_threads(int num_threads){ mkl_set_num_threads(num_threads); }
+  // A previous value of 0 means no thread-local count was set, and restores the global one
+  static int set_num_threads_local(int num_threads){ return mkl_set_num_threads_local(num_threads); }
+};
+using active = mkl;
+#endif
+}
+
+#endif /* UTIL_BACKEND_H_ */
@@ -0,0 +1,63 @@
+/* Author: Edward Hutter */
+
+#ifndef UTIL_MICROKERNEL_H_
+#define UTIL_MICROKERNEL_H_
+
+#include "shared.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+// Fixed-size kernels for the small triangular problems at the base case and recursion leaves, where the per-call overhead of the
+//   BLAS/LAPACK backend dominates. The triangle is packed into an aligned local buffer whose leading dimension N (16, 32 or 64) is
+//   a compile-time constant, so every column is contiguous and aligned and the buffer stays in L1. Inner products and updates use
+//   AVX or SSE2 intrinsics when the target has them and plain loops otherwise.
+//   Only the column-major, upper-triangular, non-unit variants used by the algorithms are provided for float and double; the
+//   engines route a call here when its triangular order is at most order_threshold() and fall back to the library otherwise.
+class microkernel{
+public:
+  static int& order_threshold();
+
+  // A <- U with A = U^T*U
+  template<typename T>
+  static void potrf(T* matrixA, int n, int lda);
+  // A <- A^{-1}
+  template<typename T>
+  static void trtri(T* matrixA, int n, int lda);
+  // B <- alpha*op(A)*B (left side, A of order m) or B <- alpha*B*A (right side, A of order n)
+  template<typename T>
+  static void trmm(const T* matrixA, T* matrixB, int m, int n, int lda, int ldb, bool left, bool trans, T alpha);
+
+private:
+  template<typename T, int N>
+  static void _potrf(T* matrixA, int n, int lda);
+  template<typename T, int N>
+  static void _trtri(T* matrixA, int n, int lda);
+  template<typename T, int N>
+  static void _trmm(const T* matrixA, T* matrixB, int m, int n, int lda, int ldb, bool left, bool trans, T alpha);
+
+  template<typename T, int N>
+  static void _pack(T* work, const T* matrixA, int n, int lda);
+  template<typename T, int N>
+  static void _unpack(T* matrixA, const T* work, int n, int lda);
+
+  template<typename T>
+  static T _dot(const T* x, const T* y, int len);
+  template<typename T>
+  static void _dot4(const T* x, T* const* y, int len, T* result);
+  template<typename T>
+  static void _axpy(T* y, const T* x, T alpha, int len);
+#if defined(__AVX__) || defined(__SSE2__)
+  static double _dot(const double* x, const double* y, int len);
+  static void _dot4(const double* x, double* const* y, int len, double* result);
+  static void _axpy(double* y, const double* x, double alpha, int len);
+#endif
+#ifdef __SSE2__
+  static float _dot(const float* x, const float* y, int len);
+  static void _axpy(float* y, const float* x, float alpha, int len);
+#endif
+};
+
+#include "microkernel.hpp"
+
+#endif /* UTIL_MICROKERNEL_H_ */
@@ -0,0 +1,244 @@
+/* Author: Edward Hutter */
+
+// Triangular orders at or below this use the fixed-size kernels; the default of 64 covers all of them. 0 sends every call to the library.
+//   Lower it where bench/cholesky/microkernel shows the tuned library routines catching up sooner.
+inline int& microkernel::order_threshold(){
+  static int n = 64;
+  return n;
+}
+
+template<typename T>
+void microkernel::potrf(T* matrixA, int n, int lda){
+  assert(n <= 64);
+  if (n <= 16) _potrf<T,16>(matrixA,n,lda);
+  else if (n <= 32) _potrf<T,32>(matrixA,n,lda);
+  else _potrf<T,64>(matrixA,n,lda);
+}
+
+template<typename T>
+void microkernel::trtri(T* matrixA, int n, int lda){
+  assert(n <= 64);
+  if (n <= 16) _trtri<T,16>(matrixA,n,lda);
+  else if (n <= 32) _trtri<T,32>(matrixA,n,lda);
+  else _trtri<T,64>(matrixA,n,lda);
+}
+
+template<typename T>
+void microkernel::trmm(const T* matrixA, T* matrixB, int m, int n, int lda, int ldb, bool left, bool trans, T alpha){
+  int order = left ? m : n;
+  assert(order <= 64);
+  if (order <= 16) _trmm<T,16>(matrixA,matrixB,m,n,lda,ldb,left,trans,alpha);
+  else if (order <= 32) _trmm<T,32>(matrixA,matrixB,m,n,lda,ldb,left,trans,alpha);
+  else _trmm<T,64>(matrixA,matrixB,m,n,lda,ldb,left,trans,alpha);
+}
+
+// Dot-product form: U(i,j) = (A(i,j) - U(0:i,i)^T*U(0:i,j))/U(i,i), so both operands are contiguous column segments
+template<typename T, int N>
+void microkernel::_potrf(T* matrixA, int n, int lda){
+  alignas(64) T work[N*N];
+  _pack<T,N>(work,matrixA,n,lda);
+  for (int j=0; j<n; j++){
+    T* col = &work[j*N];
+    for (int i=0; i<j; i++){ col[i] = (col[i] - _dot(&work[i*N],col,i)) / work[i*N+i]; }
+    T ajj = col[j] - _dot(col,col,j);
+    // As in potf2, a non-positive pivot is stored unrooted and ends the factorization
+    if (!(ajj > T(0))){ col[j] = ajj; _unpack<T,N>(matrixA,work,j+1,lda); return; }
+    col[j] = std::sqrt(ajj);
+  }
+  _unpack<T,N>(matrixA,work,n,lda);
+}
+
+// Column j of the inverse is -U^{-1}(0:j,0:j)*U(0:j,j)/U(j,j), formed with the columns already inverted (as in trti2)
+template<typename T, int N>
+void microkernel::_trtri(T* matrixA, int n, int lda){
+  alignas(64) T work[N*N];
+  _pack<T,N>(work,matrixA,n,lda);
+  for (int j=0; j<n; j++){
+    T* col = &work[j*N];
+    col[j] = T(1)/col[j];
+    T ajj = -col[j];
+    for (int k=0; k<j; k++){
+      T temp = col[k];
+      _axpy(col,&work[k*N],temp,k);
+      col[k] = temp*work[k*N+k];
+    }
+    for (int i=0; i<j; i++){ col[i] *= ajj; }
+  }
+  _unpack<T,N>(matrixA,work,n,lda);
+}
+
+template<typename T, int N>
+void microkernel::_trmm(const T* matrixA, T* matrixB, int m, int n, int lda, int ldb, bool left, bool trans, T alpha){
+  alignas(64) T work[N*N];
+  if (left){
+    _pack<T,N>(work,matrixA,m,lda);
+    if (trans){
+      // Bottom-up, so the leading entries read by each dot product are still the original ones. Four columns of B share each
+      //   load of the packed column of A.
+      int c=0;
+      for (; c+4<=n; c+=4){
+        T* cols[4] = {&matrixB[c*ldb],&matrixB[(c+1)*ldb],&matrixB[(c+2)*ldb],&matrixB[(c+3)*ldb]};
+        T sums[4];
+        for (int i=m-1; i>=0; i--){
+          _dot4(&work[i*N],cols,i+1,sums);
+          for (int j=0; j<4; j++){ cols[j][i] = alpha*sums[j]; }
+        }
+      }
+      for (; c<n; c++){
+        T* col = &matrixB[c*ldb];
+        for (int i=m-1; i>=0; i--){ col[i] = alpha*_dot(&work[i*N],col,i+1); }
+      }
+    }
+    else{
+      for (int c=0; c<n; c++){
+        T* col = &matrixB[c*ldb];
+        for (int k=0; k<m; k++){
+          T temp = alpha*col[k];
+          _axpy(col,&work[k*N],temp,k);
+          col[k] = temp*work[k*N+k];
+        }
+      }
+    }
+  }
+  else{
+    // Right-to-left over the columns of B, so the columns combined into column j are still the original ones
+    _pack<T,N>(work,matrixA,n,lda);
+    for (int j=n-1; j>=0; j--){
+      T* col = &matrixB[j*ldb];
+      T scale = alpha*work[j*N+j];
+      for (int i=0; i<m; i++){ col[i] *= scale; }
+      for (int k=0; k<j; k++){ _axpy(col,&matrixB[k*ldb],alpha*work[j*N+k],m); }
+    }
+  }
+}
+
+// Only the upper triangle is copied; the kernels never read below the diagonal
+template<typename T, int N>
+void microkernel::_pack(T* work, const T* matrixA, int n, int lda){
+  for (int j=0; j<n; j++){ memcpy(&work[j*N],&matrixA[j*lda],(j+1)*sizeof(T)); }
+}
+
+template<typename T, int N>
+void microkernel::_unpack(T* matrixA, const T* work, int n, int lda){
+  for (int j=0; j<n; j++){ memcpy(&matrixA[j*lda],&work[j*N],(j+1)*sizeof(T)); }
+}
+
+template<typename T>
+T microkernel::_dot(const T* x, const T* y, int len){
+  T sum = 0;
+  for (int i=0; i<len; i++){ sum += x[i]*y[i]; }
+  return sum;
+}
+
+template<typename T>
+void microkernel::_dot4(const T* x, T* const* y, int len, T* result){
+  for (int j=0; j<4; j++){ result[j] = _dot(x,y[j],len); }
+}
+
+template<typename T>
+void microkernel::_axpy(T* y, const T* x, T alpha, int len){
+  for (int i=0; i<len; i++){ y[i] += alpha*x[i]; }
+}
+
+#ifdef __AVX__
+// Two independent accumulators hide the add latency; the trailing elements are handled as scalars
+inline double microkernel::_dot(const double* x, const double* y, int len){
+  __m256d sum0 = _mm256_setzero_pd(); __m256d sum1 = _mm256_setzero_pd();
+  int i=0;
+  for (; i+8<=len; i+=8){
+    sum0 = _mm256_add_pd(sum0,_mm256_mul_pd(_mm256_loadu_pd(&x[i]),_mm256_loadu_pd(&y[i])));
+    sum1 = _mm256_add_pd(sum1,_mm256_mul_pd(_mm256_loadu_pd(&x[i+4]),_mm256_loadu_pd(&y[i+4])));
+  }
+  for (; i+4<=len; i+=4){ sum0 = _mm256_add_pd(sum0,_mm256_mul_pd(_mm256_loadu_pd(&x[i]),_mm256_loadu_pd(&y[i]))); }
+  sum0 = _mm256_add_pd(sum0,sum1);
+  __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum0),_mm256_extractf128_pd(sum0,1));
+  double sum = _mm_cvtsd_f64(half) + _mm_cvtsd_f64(_mm_unpackhi_pd(half,half));
+  for (; i<len; i++){ sum += x[i]*y[i]; }
+  return sum;
+}
+
+inline void microkernel::_dot4(const double* x, double* const* y, int len, double* result){
+  __m256d sum0 = _mm256_setzero_pd(); __m256d sum1 = _mm256_setzero_pd(); __m256d sum2 = _mm256_setzero_pd(); __m256d sum3 = _mm256_setzero_pd();
+  int i=0;
+  for (; i+4<=len; i+=4){
+    __m256d a = _mm256_loadu_pd(&x[i]);
+    sum0 = _mm256_add_pd(sum0,_mm256_mul_pd(a,_mm256_loadu_pd(&y[0][i])));
+    sum1 = _mm256_add_pd(sum1,_mm256_mul_pd(a,_mm256_loadu_pd(&y[1][i])));
+    sum2 = _mm256_add_pd(sum2,_mm256_mul_pd(a,_mm256_loadu_pd(&y[2][i])));
+    sum3 = _mm256_add_pd(sum3,_mm256_mul_pd(a,_mm256_loadu_pd(&y[3][i])));
+  }
+  // hadd leaves {s0[0]+s0[1],s1[0]+s1[1],s0[2]+s0[3],s1[2]+s1[3]}; adding the two halves completes each sum
+  __m256d sum01 = _mm256_hadd_pd(sum0,sum1); __m256d sum23 = _mm256_hadd_pd(sum2,sum3);
+  _mm_storeu_pd(&result[0],_mm_add_pd(_mm256_castpd256_pd128(sum01),_mm256_extractf128_pd(sum01,1)));
+  _mm_storeu_pd(&result[2],_mm_add_pd(_mm256_castpd256_pd128(sum23),_mm256_extractf128_pd(sum23,1)));
+  for (; i<len; i++){ for (int j=0; j<4; j++){ result[j] += x[i]*y[j][i]; } }
+}
+
+inline void microkernel::_axpy(double* y, const double* x, double alpha, int len){
+  __m256d a = _mm256_set1_pd(alpha);
+  int i=0;
+  for (; i+4<=len; i+=4){ _mm256_storeu_pd(&y[i],_mm256_add_pd(_mm256_loadu_pd(&y[i]),_mm256_mul_pd(a,_mm256_loadu_pd(&x[i])))); }
+  for (; i<len; i++){ y[i] += alpha*x[i]; }
+}
+#elif defined(__SSE2__)
+// Two independent accumulators hide the add latency; the trailing elements are handled as scalars
+inline double microkernel::_dot(const double* x, const double* y, int len){
+  __m128d sum0 = _mm_setzero_pd(); __m128d sum1 = _mm_setzero_pd();
+  int i=0;
+  for (; i+4<=len; i+=4){
+    sum0 = _mm_add_pd(sum0,_mm_mul_pd(_mm_loadu_pd(&x[i]),_mm_loadu_pd(&y[i])));
+    sum1 = _mm_add_pd(sum1,_mm_mul_pd(_mm_loadu_pd(&x[i+2]),_mm_loadu_pd(&y[i+2])));
+  }
+  sum0 = _mm_add_pd(sum0,sum1);
+  double sum = _mm_cvtsd_f64(sum0) + _mm_cvtsd_f64(_mm_unpackhi_pd(sum0,sum0));
+  for (; i<len; i++){ sum += x[i]*y[i]; }
+  return sum;
+}
+
+inline void microkernel::_axpy(double* y, const double* x, double alpha, int len){
+  __m128d a = _mm_set1_pd(alpha);
+  int i=0;
+  for (; i+2<=len; i+=2){ _mm_storeu_pd(&y[i],_mm_add_pd(_mm_loadu_pd(&y[i]),_mm_mul_pd(a,_mm_loadu_pd(&x[i])))); }
+  for (; i<len; i++){ y[i] += alpha*x[i]; }
+}
+
+inline void microkernel::_dot4(const double* x, double* const* y, int len, double* result){
+  __m128d sum0 = _mm_setzero_pd(); __m128d sum1 = _mm_setzero_pd(); __m128d sum2 = _mm_setzero_pd(); __m128d sum3 = _mm_setzero_pd();
+  int i=0;
+  for (; i+2<=len; i+=2){
+    __m128d a = _mm_loadu_pd(&x[i]);
+    sum0 = _mm_add_pd(sum0,_mm_mul_pd(a,_mm_loadu_pd(&y[0][i])));
+    sum1 = _mm_add_pd(sum1,_mm_mul_pd(a,_mm_loadu_pd(&y[1][i])));
+    sum2 = _mm_add_pd(sum2,_mm_mul_pd(a,_mm_loadu_pd(&y[2][i])));
+    sum3 = _mm_add_pd(sum3,_mm_mul_pd(a,_mm_loadu_pd(&y[3][i])));
+  }
+  // Pairwise horizontal sums: {sum0,sum1} and {sum2,sum3}
+  _mm_storeu_pd(&result[0],_mm_add_pd(_mm_unpacklo_pd(sum0,sum1),_mm_unpackhi_pd(sum0,sum1)));
+  _mm_storeu_pd(&result[2],_mm_add_pd(_mm_unpacklo_pd(sum2,sum3),_mm_unpackhi_pd(sum2,sum3)));
+  for (; i<len; i++){ for (int j=0; j<4; j++){ result[j] += x[i]*y[j][i]; } }
+}
+
+#endif
+
+#ifdef __SSE2__
+inline float microkernel::_dot(const float* x, const float* y, int len){
+  __m128 sum0 = _mm_setzero_ps(); __m128 sum1 = _mm_setzero_ps();
+  int i=0;
+  for (; i+8<=len; i+=8){
+    sum0 = _mm_add_ps(sum0,_mm_mul_ps(_mm_loadu_ps(&x[i]),_mm_loadu_ps(&y[i])));
+    sum1 = _mm_add_ps(sum1,_mm_mul_ps(_mm_loadu_ps(&x[i+4]),_mm_loadu_ps(&y[i+4])));
+  }
+  alignas(16) float lanes[4];
+  _mm_store_ps(lanes,_mm_add_ps(sum0,sum1));
+  float sum = (lanes[0]+lanes[1]) + (lanes[2]+lanes[3]);
+  for (; i<len; i++){ sum += x[i]*y[i]; }
+  return sum;
+}
+
+inline void microkernel::_axpy(float* y, const float* x, float alpha, int len){
+  __m128 a = _mm_set1_ps(alpha);
+  int i=0;
+  for (; i+4<=len; i+=4){ _mm_storeu_ps(&y[i],_mm_add_ps(_mm_loadu_ps(&y[i]),_mm_mul_ps(a,_mm_loadu_ps(&x[i])))); }
+  for (; i<len; i++){ y[i] += alpha*x[i]; }
+}
+#endif
@@ -11,25 +11,37 @@
 #include <stdio.h>
 #include <complex>
 #include <vector>
+#include <array>
+#include <limits>
 #include <map>
+#include <list>
 #include <algorithm>
 #include <utility>
+#include <type_traits>
 #include <tuple>
 #include <cmath>
 #include <string>
+#include <new>
+#include <system_error>
+#include <cerrno>
 #include <assert.h>
 #include <complex>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include <mpi.h>
-#include "mkl.h"
+#include "backend.h"
 
 #ifdef CRITTER
 #include "critter.h"
 #else
-//#ifdef PORTER
-//#include <cblas.h>
-//#include "/home/hutter2/hutter2/external/BLAS/OpenBLAS/lapack-netlib/LAPACKE/include/lapacke.h"
-//#endif
 #define CRITTER_START(ARG)
 #define CRITTER_STOP(ARG)
 #endif
@@ -47,6 +59,137 @@ class mpi_type<double>{
 public:
   constexpr static size_t type = MPI_DOUBLE;
 };
+template<>
+class mpi_type<std::complex<float>>{
+public:
+  constexpr static size_t type = MPI_CXX_FLOAT_COMPLEX;
+};
+template<>
+class mpi_type<std::complex<double>>{
+public:
+  constexpr static size_t type = MPI_CXX_DOUBLE_COMPLEX;
+};
+
+template<typename ScalarType>
+struct is_complex : std::false_type{};
+template<typename ScalarType>
+struct is_complex<std::complex<ScalarType>> : std::true_type{};
+
+// std::conj promotes real arguments to std::complex, so real types pass through unchanged here
+template<typename ScalarType>
+inline ScalarType conjugate(ScalarType val){ return val; }
+template<typename ScalarType>
+inline std::complex<ScalarType> conjugate(std::complex<ScalarType> val){ return std::conj(val); }
+
+// Committed derived datatypes for sub-ranges of local buffers. Each is built on first use and cached until MPI_Finalize frees it, so a
+//   collective can send or receive a strided or triangular block in place rather than staging it through a contiguous copy.
+template<typename ScalarType>
+class mpi_subtype{
+public:
+  // numColumns columns of numRows elements, ld elements apart
+  static MPI_Datatype strided(int64_t numRows, int64_t numColumns, int64_t ld){
+    std::vector<int64_t> key = {-1,numRows,numColumns,ld};
+    auto it = cache().find(key); if (it != cache().end()) return it->second;
+    MPI_Datatype type;
+    MPI_Type_vector(numColumns, numRows, ld, mpi_type<ScalarType>::type, &type);
+    return insert(key,type);
+  }
+
+  // The part of columns [sx,ex) and rows [sy,ey) of one buffer of a matrix that lies on or above ('U') or below ('L') its diagonal,
+  //   in column order. Displacements are taken from the structure's offsets and are relative to the start of the buffer.
+  template<typename MatrixType>
+  static MPI_Datatype triangle(const MatrixType& M, int64_t sx, int64_t ex, int64_t sy, int64_t ey, size_t buffer, char dir){
+    std::vector<int64_t> key = {MatrixType::StructureType::_structure_id,M.num_rows_local(),M.num_columns_local(),int64_t(buffer),sx,ex,sy,ey,dir};
+    auto it = cache().find(key); if (it != cache().end()) return it->second;
+    std::vector<int> counts; std::vector<MPI_Aint> offsets;
+    for (int64_t x=sx; x<ex; x++){
+      int64_t first = (dir=='U' ? sy : std::max(sy,x)); int64_t last = (dir=='U' ? std::min(ey,x+1) : ey);
+      if (last <= first) continue;
+      int64_t start = M.offset_local(x,first,buffer);
+      // rfp stores the columns left of its middle as rows, so those are described one element at a time
+      if (M.offset_local(x,last-1,buffer)-start == last-first-1){ counts.push_back(last-first); offsets.push_back(start*sizeof(ScalarType)); }
+      else{ for (int64_t y=first; y<last; y++){ counts.push_back(1); offsets.push_back(M.offset_local(x,y,buffer)*sizeof(ScalarType)); } }
+    }
+    MPI_Datatype type;
+    MPI_Type_create_hindexed(counts.size(), counts.size()>0 ? &counts[0] : nullptr, counts.size()>0 ? &offsets[0] : nullptr, mpi_type<ScalarType>::type, &type);
+    return insert(key,type);
+  }
+
+private:
+  static std::map<std::vector<int64_t>,MPI_Datatype>& cache(){
+    static std::map<std::vector<int64_t>,MPI_Datatype> c;
+    return c;
+  }
+
+  static MPI_Datatype insert(const std::vector<int64_t>& key, MPI_Datatype type){
+    // The first cached type attaches an attribute to MPI_COMM_SELF, whose delete callback MPI_Finalize runs before shutting down
+    if (cache().empty()){
+      int keyval; MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, release, &keyval, nullptr);
+      MPI_Comm_set_attr(MPI_COMM_SELF, keyval, nullptr);
+    }
+    MPI_Type_commit(&type);
+    cache()[key] = type;
+    return type;
+  }
+
+  static int release(MPI_Comm comm, int keyval, void* attribute, void* state){
+    for (auto& it : cache()){ MPI_Type_free(&it.second); }
+    cache().clear(); MPI_Comm_free_keyval(&keyval);
+    return MPI_SUCCESS;
+  }
+};
+
+// Progresses the requests posted through an instance from one helper thread that lives as long as the instance, so that nonblocking
+//   collectives advance while the owner computes, even where MPI progresses them only inside MPI calls. Posts and the helper's tests
+//   are serialized by a mutex, and the owner must make no other MPI call until wait, so MPI_THREAD_SERIALIZED is sufficient. Below
+//   that level no thread is started (see active), and the posted requests are instead tested at each post.
+class mpi_progress{
+public:
+  explicit mpi_progress(int capacity) : _stop(false), _count(0), _requests(capacity,MPI_REQUEST_NULL){
+    int provided; MPI_Query_thread(&provided);
+    if (capacity > 0 && provided >= MPI_THREAD_SERIALIZED){
+      this->_thread = std::thread([this](){
+        while (!this->_stop.load(std::memory_order_acquire)){ this->test(); std::this_thread::yield(); }
+      });
+    }
+  }
+  ~mpi_progress(){ this->join(); }
+  mpi_progress(const mpi_progress& rhs) = delete;
+  mpi_progress& operator=(const mpi_progress& rhs) = delete;
+
+  bool active() const { return this->_thread.joinable(); }
+
+  // PostType is called with the next request slot and must start exactly one nonblocking operation in it
+  template<typename PostType>
+  void post(PostType&& start){
+    assert(this->_count < int(this->_requests.size()));
+    { std::lock_guard<std::mutex> lock(this->_mutex); start(&this->_requests[this->_count]); this->_count++; }
+    if (!this->active()){ this->test(); }
+  }
+
+  // Stops the helper and completes every posted request
+  void wait(){
+    this->join();
+    MPI_Waitall(this->_count, this->_requests.data(), MPI_STATUSES_IGNORE);
+  }
+
+private:
+  void test(){
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    int flag; if (this->_count > 0){ MPI_Testall(this->_count, this->_requests.data(), &flag, MPI_STATUSES_IGNORE); }
+  }
+
+  void join(){
+    this->_stop.store(true, std::memory_order_release);
+    if (this->_thread.joinable()){ this->_thread.join(); }
+  }
+
+  std::atomic<bool> _stop;
+  int _count;
+  std::vector<MPI_Request> _requests;
+  std::mutex _mutex;
+  std::thread _thread;
+};
 
 
 #endif /*SHARED*/
@@ -5,6 +5,17 @@
 
 class util{
 public:
+  // Frobenius, max and, when one_norm is set, one (max column sum) norms of the error and control values produced by a residual lambda
+  template<typename RealType>
+  struct norm_info{
+    RealType error_frobenius, error_max, error_one;
+    RealType control_frobenius, control_max, control_one;
+  };
+
+  template<typename MatrixType, typename RefMatrixType, typename LambdaType>
+  static norm_info<decltype(std::abs(typename MatrixType::ScalarType()))>
+    norms(MatrixType& Matrix, RefMatrixType& RefMatrix, LambdaType&& Lambda, MPI_Comm slice, int64_t sliceX, int64_t sliceY, int64_t sliceDimX, int64_t sliceDimY, bool one_norm=false);
+
   template<typename MatrixType, typename CommType>
   static typename MatrixType::ScalarType get_identity_residual(MatrixType& Matrix, CommType&& CommInfo, MPI_Comm comm);
 
@@ -27,9 +38,28 @@ public:
   template<typename ScalarType>
   static void cyclic_to_block_rect(ScalarType* dest, ScalarType* src, int num_rows_local, int num_columns_local, int sliceDim);
 
+  // Exchange started by transpose_start. The source must not be written, nor the destination read, until transpose_finish.
+  template<typename ScalarType>
+  struct transpose_request{
+    MPI_Request requests[2];
+    std::vector<ScalarType> scratch;
+    ScalarType* src;
+    int64_t num_rows, num_columns, num_elems;
+    bool self;
+  };
+
   template<typename MatrixType, typename CommType>
   static void transpose(MatrixType& mat, CommType&& CommInfo);
 
+  template<typename MatrixType, typename CommType>
+  static void transpose(MatrixType& src, MatrixType& dest, CommType&& CommInfo);
+
+  template<typename MatrixType, typename CommType>
+  static transpose_request<typename MatrixType::ScalarType> transpose_start(MatrixType& src, CommType&& CommInfo);
+
+  template<typename MatrixType>
+  static void transpose_finish(transpose_request<typename MatrixType::ScalarType>& request, MatrixType& dest, bool local=false);
+
   static int64_t get_next_power2(int64_t localShift);
 
   template<typename MatrixType>
@@ -37,6 +67,22 @@ public:
 
   template<typename MatrixType>
   static void remove_triangle_local(MatrixType& matrix, int64_t sliceX, int64_t sliceY, int64_t sliceDim, char dir);
+
+private:
+  template<typename CommType>
+  static int64_t _transpose_partner(CommType&& CommInfo);
+
+  template<typename RealType>
+  static void _norm_reduce(void* in, void* inout, int* len, MPI_Datatype* type);
+
+  template<typename RealType>
+  static MPI_Op _norm_op();
+
+  template<typename ScalarType>
+  static void _block_to_cyclic(ScalarType* blocked, ScalarType* cyclic, int64_t offset, int64_t num_rows_local, int64_t num_columns_local, int64_t sliceDim, bool packed);
+
+  template<typename ScalarType>
+  static void _cyclic_to_block(ScalarType* blocked, ScalarType* cyclic, int64_t offset, int64_t num_rows_local, int64_t num_columns_local, int64_t sliceDim, bool packed);
 };
 
 #include "util.hpp"
@@ -1,55 +1,79 @@
 /* Author: Edward Hutter */
 
-template<typename MatrixType, typename CommType>
-typename MatrixType::ScalarType util::get_identity_residual(MatrixType& Matrix, CommType&& CommInfo, MPI_Comm comm){
-  // Should be offloaded to Matrix definition, which knows how best to iterate over matrix?
-  // Should this be made more general so that user can supply a Lambda and more than the max can be obtained in this interface?
-  using T = typename MatrixType::ScalarType; using U = typename MatrixType::DimensionType;
-  T res = 0; U localNumRows = Matrix.num_rows_local(); U localNumColumns = Matrix.num_columns_local();
-  U globalX = CommInfo.x; U globalY = CommInfo.y; U index=0;
-  for (int64_t i=0; i<localNumColumns; i++){
-    globalY = CommInfo.y;// reset
-    for (int64_t j=0; j<localNumRows; j++){
-      if ((globalX<globalNumRows) && (globalY<globalNumColumns)){
-        if (globalX == globalY){ res += 1.-Matrix.data()[index++]; }
-        else { res += Matrix.data()[index++]; }
-      }
-      globalY += CommInfo.d;
+// Layout of the reduction record: error and control sums of squares, error and control maxima, and with one_norm, the error and control
+//   maximum column sums. Column sums are first reduced over the processes that share the column, so the record over the slice stays
+//   scalar-sized. A single record is one element of a contiguous type, so MPI never splits it.
+template<typename MatrixType, typename RefMatrixType, typename LambdaType>
+util::norm_info<decltype(std::abs(typename MatrixType::ScalarType()))>
+util::norms(MatrixType& Matrix, RefMatrixType& RefMatrix, LambdaType&& Lambda, MPI_Comm slice, int64_t sliceX, int64_t sliceY, int64_t sliceDimX, int64_t sliceDimY, bool one_norm){
+  using R = decltype(std::abs(typename MatrixType::ScalarType()));
+  int64_t localNumRows = Matrix.num_rows_local(); int64_t globalNumRows = Matrix.num_rows_global();
+  int64_t localNumColumns = Matrix.num_columns_local(); int64_t globalNumColumns = Matrix.num_columns_global();
+  // Bounds are resolved once: padding columns and rows are never visited
+  int64_t numColumns = sliceX < globalNumColumns ? std::min(localNumColumns,(globalNumColumns-sliceX+sliceDimX-1)/sliceDimX) : 0;
+  int64_t numRows = sliceY < globalNumRows ? std::min(localNumRows,(globalNumRows-sliceY+sliceDimY-1)/sliceDimY) : 0;
+  std::vector<R> record(one_norm ? 6 : 4,0), columns(one_norm ? 2*numColumns : 0,0);
+  R error_sum=0, control_sum=0, error_max=0, control_max=0;
+
+  #pragma omp parallel for schedule(static) reduction(+:error_sum,control_sum) reduction(max:error_max,control_max)
+  for (int64_t i=0; i<numColumns; i++){
+    int64_t globalX = sliceX + i*sliceDimX;
+    R error_column=0, control_column=0;
+    #pragma omp simd reduction(+:error_sum,control_sum,error_column,control_column) reduction(max:error_max,control_max)
+    for (int64_t j=0; j<numRows; j++){
+      auto info = Lambda(Matrix, RefMatrix, i*localNumRows+j, globalX, sliceY+j*sliceDimY);
+      R error = std::abs(info.first); R control = std::abs(info.second);
+      error_sum += error*error; control_sum += control*control;
+      error_max = std::max(error_max,error); control_max = std::max(control_max,control);
+      error_column += error; control_column += control;
     }
-    globalX += CommInfo.d;//TODO: This will not work for a rectangular grid (i.e. CommType is RectTopo)
+    if (one_norm){ columns[2*i] = error_column; columns[2*i+1] = control_column; }
+  }
+  record[0] = error_sum; record[1] = control_sum; record[2] = error_max; record[3] = control_max;
+  if (one_norm){
+    MPI_Comm column; MPI_Comm_split(slice, sliceX, sliceY, &column);
+    if (numColumns > 0){ MPI_Allreduce(MPI_IN_PLACE, &columns[0], 2*numColumns, mpi_type<R>::type, MPI_SUM, column); }
+    MPI_Comm_free(&column);
+    for (int64_t i=0; i<numColumns; i++){ record[4] = std::max(record[4],columns[2*i]); record[5] = std::max(record[5],columns[2*i+1]); }
   }
-  MPI_Allreduce(MPI_IN_PLACE,&res,1,mpi_type<T>::type, MPI_SUM, comm);
-  return res;
+
+  MPI_Allreduce(MPI_IN_PLACE, &record[0], 1, mpi_subtype<R>::strided(record.size(),1,record.size()), _norm_op<R>(), slice);
+  return norm_info<R>{std::sqrt(record[0]), record[2], one_norm ? record[4] : 0, std::sqrt(record[1]), record[3], one_norm ? record[5] : 0};
+}
+
+template<typename RealType>
+void util::_norm_reduce(void* in, void* inout, int* len, MPI_Datatype* type){
+  int size; MPI_Type_size(*type,&size);
+  int64_t count = size/sizeof(RealType);
+  for (int64_t i=0; i<*len; i++){
+    RealType* a = (RealType*)in + i*count; RealType* b = (RealType*)inout + i*count;
+    b[0] += a[0]; b[1] += a[1];
+    for (int64_t j=2; j<count; j++){ b[j] = std::max(b[j],a[j]); }
+  }
+}
+
+template<typename RealType>
+MPI_Op util::_norm_op(){
+  static MPI_Op op = [](){ MPI_Op o; MPI_Op_create(&util::_norm_reduce<RealType>, 1, &o); return o; }();
+  return op;
+}
+
+template<typename MatrixType, typename CommType>
+typename MatrixType::ScalarType util::get_identity_residual(MatrixType& Matrix, CommType&& CommInfo, MPI_Comm comm){
+  // Frobenius norm of I - Matrix
+  auto Lambda = [](auto&& matrix, auto&& ref, size_t index, size_t sliceX, size_t sliceY){
+    using T = typename std::remove_reference_t<decltype(matrix)>::ScalarType;
+    T val = (sliceX == sliceY ? T(1.)-matrix.data()[index] : matrix.data()[index]);
+    return std::make_pair(val,T(0));
+  };
+  return norms(Matrix, Matrix, std::move(Lambda), comm, CommInfo.x, CommInfo.y, CommInfo.d, CommInfo.d).error_frobenius;
 }
 
 template<typename MatrixType, typename RefMatrixType, typename LambdaType>
 typename MatrixType::ScalarType
 util::residual_local(MatrixType& Matrix, RefMatrixType& RefMatrix, LambdaType&& Lambda, MPI_Comm slice, int64_t sliceX, int64_t sliceY, int64_t sliceDimX, int64_t sliceDimY){
-  using T = typename MatrixType::ScalarType; using U = typename MatrixType::DimensionType;
-  int rank; MPI_Comm_rank(MPI_COMM_WORLD,&rank); T error = 0; T control = 0;
-  U localNumRows = Matrix.num_rows_local(); U globalNumRows = Matrix.num_rows_global();
-  U localNumColumns = Matrix.num_columns_local(); U globalNumColumns = Matrix.num_columns_global();
-  U globalX = sliceX; U globalY = sliceY;
-
-  for (int64_t i=0; i<localNumColumns; i++){
-    globalY = sliceY;    // reset
-    for (int64_t j=0; j<localNumRows; j++){
-      if ((globalX<globalNumRows) && (globalY<globalNumColumns)){
-        auto info = Lambda(Matrix, RefMatrix, i*localNumRows+j,globalX, globalY);
-        error += std::abs(info.first*info.first); control += std::abs(info.second*info.second);
-        /*int rank; MPI_Comm_rank(MPI_COMM_WORLD,&rank);
-        if (info.first >= 1.e-8 && rank==0){std::cout << "current error - " << error << " global index - " << i*localNumRows+j << " local index - (" << i << "," << j << ") global index - ("\
-                                                      << globalX << "," << globalY << ")\n\t\t\tlocal dimensions - (" << localNumColumns << "," << localNumRows << ") global dimensions - (" << globalNumColumns << "," << globalNumRows << ")\n\t\t\t error - " << info.first << " A value - " << info.second << " process grid id - (" << sliceX << "," << sliceY << ")\n";}*/
-      }
-      globalY += sliceDimY;
-    }
-    globalX += sliceDimX;
-  }
-
-  MPI_Allreduce(MPI_IN_PLACE, &error, 1, mpi_type<T>::type, MPI_SUM, slice);
-  MPI_Allreduce(MPI_IN_PLACE, &control, 1, mpi_type<T>::type, MPI_SUM, slice);
-  error = std::sqrt(error) / std::sqrt(control);
-  return error;
+  auto info = norms(Matrix, RefMatrix, std::forward<LambdaType>(Lambda), slice, sliceX, sliceY, sliceDimX, sliceDimY);
+  return info.error_frobenius / info.control_frobenius;
 }
 
 // Note: this method differs from the one below it because blockedData is in packed storage
@@ -59,37 +83,7 @@ void util::block_to_cyclic_triangle(ScalarType* blocked, ScalarType* cyclic, int
 CRITTER_START(blk2cyc_tri);
 #endif
   // Note this is used in cholinv and nowhere else, so if used for a different algorithm, need to rethink interface
-  int64_t num_rows_global = num_rows_local*sliceDim; int64_t num_columns_global = num_columns_local*sliceDim;
-  int64_t write_idx=0; int64_t read_idx=0;
-
-  write_idx = 0; int64_t offset = num_elems/(sliceDim*sliceDim);
-  int64_t off1 = 0; int64_t off3 = sliceDim*offset;
-  for (int64_t i=0; i<num_columns_local; i++){
-    off1 += i;
-    for (int64_t j=0; j<sliceDim; j++){
-      int64_t off2 = j*offset + off1;
-      write_idx = ((i*sliceDim)+j)*num_rows_global;    //  reset each time
-      for (int64_t k=0; k<i; k++){
-        int64_t off4 = off2;
-        for (int64_t z=0; z<sliceDim; z++){
-          read_idx = off4 + z*off3 + k;
-          cyclic[write_idx++] = blocked[read_idx];
-        }
-      }
-      // Special final block
-      int64_t off4 = off2;
-      // Inner loop over all elements along columns
-      for (int64_t z=0; z<=j; z++){
-        read_idx = off4 + z*off3 + i; cyclic[write_idx++] = blocked[read_idx];
-      }
-    }
-  }
-  // Remove scalars that should be zeros
-  for (int64_t i=0; i<num_columns_global; i++){
-    for (int64_t j=i+1; j<num_rows_global; j++){
-      cyclic[i*num_rows_global+j]=0.;
-    }
-  }
+  _block_to_cyclic(blocked, cyclic, num_elems/(sliceDim*sliceDim), num_rows_local, num_columns_local, sliceDim, true);
 #ifdef FUNCTION_SYMBOLS
 CRITTER_STOP(blk2cyc_tri);
 #endif
@@ -103,26 +97,7 @@ CRITTER_START(blk2cyc_rect);
 #ifdef CRITTER
 CRITTER_CONDITIONAL_VALUE_CAPTURE_START(blk_to_cyc);
 #endif
-//,blocked,cyclic,num_rows_local,num_columns_local,sliceDim)
-  int64_t write_idx = 0; int64_t read_idx = 0;
-  int64_t offset = num_rows_local*num_columns_local;
-  int64_t num_rows_global = num_rows_local*sliceDim; int64_t num_columns_global = num_columns_local*sliceDim;
-  for (int64_t i=0; i<num_columns_local; i++){
-    for (int64_t j=0; j<sliceDim; j++){
-      for (int64_t k=0; k<num_rows_local; k++){
-        for (int64_t z=0; z<sliceDim; z++){
-          read_idx = z*offset*sliceDim + k + j*offset + i*num_rows_local;
-          cyclic[write_idx++] = blocked[read_idx];
-        }
-      }
-    }
-  }
-  // Remove scalars that should be zeros
-  for (int64_t i=0; i<num_columns_global; i++){
-    for (int64_t j=i+1; j<num_rows_global; j++){
-      cyclic[i*num_rows_global+j]=0.;
-    }
-  }
+  _block_to_cyclic(blocked, cyclic, int64_t(num_rows_local)*num_columns_local, num_rows_local, num_columns_local, sliceDim, false);
 #ifdef CRITTER
 CRITTER_CONDITIONAL_STOP(blk_to_cyc)
 critter::symbol_invoke("blk_to_cyc",0,num_rows_local,num_columns_local,sliceDim);
@@ -169,32 +144,7 @@ void util::cyclic_to_block_triangle(ScalarType* dest, ScalarType* src, int64_t n
 #ifdef FUNCTION_SYMBOLS
 CRITTER_START(cyc2blk_tri);
 #endif
-  int64_t num_rows_global = num_rows_local*sliceDim;
-  int64_t num_columns_global = num_columns_local*sliceDim;
-  int64_t write_idx=0; int64_t read_idx=0;
-
-  write_idx = 0; int64_t offset = num_elems/(sliceDim*sliceDim);
-  int64_t off1 = 0; int64_t off3 = sliceDim*offset;
-  for (int64_t i=0; i<num_columns_local; i++){
-    off1 += i;
-    for (int64_t j=0; j<sliceDim; j++){
-      int64_t off2 = j*offset + off1;
-      write_idx = ((i*sliceDim)+j)*num_rows_global;    //  reset each time
-      for (int64_t k=0; k<i; k++){
-        int64_t off4 = off2;
-        for (int64_t z=0; z<sliceDim; z++){
-          read_idx = off4 + z*off3 + k;
-          dest[read_idx] = src[write_idx++]; src[write_idx-1]=0.;
-        }
-      }
-      // Special final block
-      int64_t off4 = off2;
-      // Inner loop over all elements along columns
-      for (int64_t z=0; z<=j; z++){
-        read_idx = off4 + z*off3 + i; dest[read_idx] = src[write_idx++]; src[write_idx-1]=0.;
-      }
-    }
-  }
+  _cyclic_to_block(dest, src, num_elems/(sliceDim*sliceDim), num_rows_local, num_columns_local, sliceDim, true);
 #ifdef FUNCTION_SYMBOLS
 CRITTER_STOP(cyc2blk_tri);
 #endif
@@ -209,17 +159,7 @@ CRITTER_START(cyc2blk_rect);
 #ifdef CRITTER
 CRITTER_CONDITIONAL_VALUE_CAPTURE_START(cyc_to_blk);
 #endif
-  int64_t write_idx = 0; int64_t read_idx = 0; int64_t offset = num_rows_local*num_columns_local;
-  for (int64_t i=0; i<num_columns_local; i++){
-    for (int64_t j=0; j<sliceDim; j++){
-      for (int64_t k=0; k<num_rows_local; k++){
-        for (int64_t z=0; z<sliceDim; z++){
-          write_idx = z*offset*sliceDim + k + j*offset + i*num_rows_local;
-          dest[write_idx] = src[read_idx++];
-        }
-      }
-    }
-  }
+  _cyclic_to_block(dest, src, int64_t(num_rows_local)*num_columns_local, num_rows_local, num_columns_local, sliceDim, false);
 #ifdef CRITTER
 CRITTER_CONDITIONAL_STOP(cyc_to_blk)
 critter::symbol_invoke("cyc_to_blk",0,num_rows_local,num_columns_local,sliceDim);
@@ -229,15 +169,51 @@ CRITTER_STOP(cyc2blk_rect);
 #endif
 }
 
+// Block (z*sliceDim+j) holds the local columns of slice process (row z, column j), so global column i*sliceDim+j interleaves local column i
+//   of the sliceDim blocks in slice column j, row k*sliceDim+z coming from row k of block z. Each global column is assembled on one thread:
+//   it stays in cache while every block contributes one contiguous run, only the rows on or above the diagonal are read, and the rows
+//   below it are zeroed in the same pass. A packed block stores local column i from offset i*(i+1)/2. Small transforms stay on one thread.
+template<typename ScalarType>
+void util::_block_to_cyclic(ScalarType* blocked, ScalarType* cyclic, int64_t offset, int64_t num_rows_local, int64_t num_columns_local, int64_t sliceDim, bool packed){
+  int64_t num_rows_global = num_rows_local*sliceDim; int64_t num_columns_global = num_columns_local*sliceDim;
+  bool threaded = num_rows_global*num_columns_global*sizeof(ScalarType) >= serialize_kernel::thread_threshold();
+  #pragma omp parallel for schedule(static,1) if(threaded)
+  for (int64_t c=0; c<num_columns_global; c++){
+    int64_t i = c/sliceDim; int64_t j = c%sliceDim; ScalarType* column = &cyclic[c*num_rows_global];
+    for (int64_t z=0; z<std::min(c+1,sliceDim); z++){
+      const ScalarType* run = &blocked[(z*sliceDim+j)*offset + (packed ? i*(i+1)/2 : i*num_rows_local)];
+      int64_t len = std::min(num_rows_local,(c-z)/sliceDim+1);
+      for (int64_t k=0; k<len; k++){ column[k*sliceDim+z] = run[k]; }
+    }
+    if (c+1 < num_rows_global) std::fill(column+c+1, column+num_rows_global, ScalarType(0));
+  }
+}
+
+// Inverse of _block_to_cyclic. A rect block receives every row of its columns. A packed block receives the rows on or above the
+//   diagonal, which are then zeroed in the cyclic source while the column is still in cache.
+template<typename ScalarType>
+void util::_cyclic_to_block(ScalarType* blocked, ScalarType* cyclic, int64_t offset, int64_t num_rows_local, int64_t num_columns_local, int64_t sliceDim, bool packed){
+  int64_t num_rows_global = num_rows_local*sliceDim; int64_t num_columns_global = num_columns_local*sliceDim;
+  bool threaded = num_rows_global*num_columns_global*sizeof(ScalarType) >= serialize_kernel::thread_threshold();
+  #pragma omp parallel for schedule(static,1) if(threaded)
+  for (int64_t c=0; c<num_columns_global; c++){
+    int64_t i = c/sliceDim; int64_t j = c%sliceDim; ScalarType* column = &cyclic[c*num_rows_global];
+    for (int64_t z=0; z<sliceDim; z++){
+      ScalarType* run = &blocked[(z*sliceDim+j)*offset + (packed ? i*(i+1)/2 : i*num_rows_local)];
+      int64_t len = (packed ? (c>=z ? std::min(num_rows_local,(c-z)/sliceDim+1) : 0) : num_rows_local);
+      for (int64_t k=0; k<len; k++){ run[k] = column[k*sliceDim+z]; }
+    }
+    if (packed) std::fill(column, column+std::min(c+1,num_rows_global), ScalarType(0));
+  }
+}
+
 template<typename MatrixType, typename CommType>
 void util::transpose(MatrixType& mat, CommType&& CommInfo){
 #ifdef FUNCTION_SYMBOLS
 CRITTER_START(transpose);
 #endif
-  using T = typename MatrixType::ScalarType;
-  int64_t TopFaceSize = CommInfo.c*CommInfo.d; int64_t FrontFaceSize = CommInfo.d*CommInfo.d;
-  int64_t transposePartner = CommInfo.layout == 0 ? CommInfo.x*TopFaceSize + CommInfo.y*CommInfo.c + CommInfo.z : CommInfo.z*FrontFaceSize + CommInfo.x*CommInfo.c + CommInfo.y;
-  MPI_Sendrecv_replace(mat.data(), mat.num_elems(), mpi_type<T>::type, transposePartner, 0, transposePartner, 0, CommInfo.world, MPI_STATUS_IGNORE);
+  auto request = transpose_start(mat, std::forward<CommType>(CommInfo));
+  transpose_finish(request, mat);
   // Note: the received data that now resides in mat is NOT transposed, and the Matrix structure is LowerTriangular
   //       This necesitates making the "else" processor serialize its data L11^{-1} from a square to a LowerTriangular,
   //       since we need to make sure that we call a MM::multiply routine with the same Structure, or else segfault.
@@ -246,6 +222,68 @@ CRITTER_STOP(transpose);
 #endif
 }
 
+// Variant for rect blocks whose local dimensions differ: dest receives the partner's block transposed locally,
+//   so dest must have src's local dimensions swapped
+template<typename MatrixType, typename CommType>
+void util::transpose(MatrixType& src, MatrixType& dest, CommType&& CommInfo){
+#ifdef FUNCTION_SYMBOLS
+CRITTER_START(transpose);
+#endif
+  auto request = transpose_start(src, std::forward<CommType>(CommInfo));
+  transpose_finish(request, dest, true);
+#ifdef FUNCTION_SYMBOLS
+CRITTER_STOP(transpose);
+#endif
+}
+
+// Posts the exchange with the transpose partner and returns immediately, so the caller can overlap it with local work
+template<typename MatrixType, typename CommType>
+util::transpose_request<typename MatrixType::ScalarType> util::transpose_start(MatrixType& src, CommType&& CommInfo){
+  using T = typename MatrixType::ScalarType;
+  transpose_request<T> request;
+  int64_t transposePartner = _transpose_partner(std::forward<CommType>(CommInfo));
+  int rank; MPI_Comm_rank(CommInfo.world,&rank);
+  request.src = src.data(); request.num_rows = src.num_rows_local(); request.num_columns = src.num_columns_local(); request.num_elems = src.num_elems();
+  request.self = (transposePartner == rank);
+  if (request.self){ request.requests[0] = request.requests[1] = MPI_REQUEST_NULL; return request; }
+  request.scratch.resize(request.num_elems);
+  MPI_Irecv(&request.scratch[0], request.num_elems, mpi_type<T>::type, transposePartner, 0, CommInfo.world, &request.requests[0]);
+  MPI_Isend(src.data(), request.num_elems, mpi_type<T>::type, transposePartner, 0, CommInfo.world, &request.requests[1]);
+  return request;
+}
+
+// Completes the exchange into dest. With local set, the received rect block is also transposed in 32x32 tiles.
+template<typename MatrixType>
+void util::transpose_finish(transpose_request<typename MatrixType::ScalarType>& request, MatrixType& dest, bool local){
+  using T = typename MatrixType::ScalarType;
+  MPI_Waitall(2, request.requests, MPI_STATUSES_IGNORE);
+  T* recv = request.self ? request.src : &request.scratch[0];
+  if (!local){
+    if (recv != dest.data()) std::memcpy(dest.data(), recv, request.num_elems*sizeof(T));
+    return;
+  }
+  assert(dest.num_rows_local() == request.num_columns && dest.num_columns_local() == request.num_rows);
+  if (recv == dest.data()){ request.scratch.assign(recv, recv+request.num_elems); recv = &request.scratch[0]; }
+  const int64_t tile = 32; T* out = dest.data();
+  #pragma omp parallel for schedule(static) if(request.num_elems*sizeof(T) >= serialize_kernel::thread_threshold())
+  for (int64_t jj=0; jj<request.num_columns; jj+=tile){
+    for (int64_t ii=0; ii<request.num_rows; ii+=tile){
+      for (int64_t j=jj; j<std::min(jj+tile,request.num_columns); j++){
+        for (int64_t i=ii; i<std::min(ii+tile,request.num_rows); i++){
+          out[i*request.num_columns+j] = recv[j*request.num_rows+i];
+        }
+      }
+    }
+  }
+}
+
+template<typename CommType>
+int64_t util::_transpose_partner(CommType&& CommInfo){
+  int64_t TopFaceSize = CommInfo.c*CommInfo.d; int64_t FrontFaceSize = CommInfo.d*CommInfo.d;
+  // Layout 0 orders ranks as (y,x,z) and layout 1 as (z,x,y); the partner swaps x and y
+  return CommInfo.layout == 0 ? CommInfo.x*TopFaceSize + CommInfo.y*CommInfo.c + CommInfo.z : CommInfo.z*FrontFaceSize + CommInfo.y*CommInfo.d + CommInfo.x;
+}
+
 int64_t util::get_next_power2(int64_t localShift){
 
   if ((localShift & (localShift-1)) != 0){
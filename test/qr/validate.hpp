@@ -24,7 +24,7 @@ validate<AlgType>::orthogonality(const MatrixType& A, ArgType& args, RectCommTyp
   auto Lambda = [](auto&& matrix, auto&& ref, size_t index, size_t sliceX, size_t sliceY){
     using T = typename std::remove_reference_t<decltype(matrix)>::ScalarType;
     T val,control;
-    if (sliceX == sliceY){ val = std::abs(1. - matrix.data()[index]); control = 1; }
+    if (sliceX == sliceY){ val = std::abs(T(1.) - matrix.data()[index]); control = 1; }
     else{ val = matrix.data()[index]; control = 1.; }
     return std::make_pair(val,control);
   };